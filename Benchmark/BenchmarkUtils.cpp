@@ -0,0 +1,91 @@
+#include "BenchmarkUtils.h"
+
+#include <atomic>
+#include <cstdlib>
+#include <new>
+#include <fstream>
+#include <iostream>
+#include <iomanip>
+
+static std::atomic<uint64_t> s_allocations(0);
+
+uint64_t AllocCounter::count()
+{
+	return s_allocations.load(std::memory_order_relaxed);
+}
+
+void* operator new(std::size_t size)
+{
+	s_allocations.fetch_add(1, std::memory_order_relaxed);
+	if (void* ptr = std::malloc(size ? size : 1))
+		return ptr;
+	throw std::bad_alloc();
+}
+
+void* operator new[](std::size_t size)
+{
+	return operator new(size);
+}
+
+void* operator new(std::size_t size, const std::nothrow_t&) noexcept
+{
+	s_allocations.fetch_add(1, std::memory_order_relaxed);
+	return std::malloc(size ? size : 1);
+}
+
+void* operator new[](std::size_t size, const std::nothrow_t& tag) noexcept
+{
+	return operator new(size, tag);
+}
+
+void operator delete(void* ptr) noexcept { std::free(ptr); }
+void operator delete[](void* ptr) noexcept { std::free(ptr); }
+void operator delete(void* ptr, std::size_t) noexcept { std::free(ptr); }
+void operator delete[](void* ptr, std::size_t) noexcept { std::free(ptr); }
+void operator delete(void* ptr, const std::nothrow_t&) noexcept { std::free(ptr); }
+void operator delete[](void* ptr, const std::nothrow_t&) noexcept { std::free(ptr); }
+
+bool BenchmarkRunner::isEnabled(const std::string& name) const
+{
+	return m_filter.empty() || name.find(m_filter) != std::string::npos;
+}
+
+void BenchmarkRunner::record(const BenchmarkResult& result)
+{
+	m_results.push_back(result);
+	std::cout << std::left << std::setw(40) << result.name << std::setw(24) << result.params
+		<< std::right << std::fixed << std::setprecision(1) << std::setw(12) << result.nsPerOp << " ns/op"
+		<< std::setprecision(2) << std::setw(10) << result.allocsPerOp << " allocs/op"
+		<< std::setw(12) << result.iterations << " iters" << std::endl;
+}
+
+static std::string escapeJson(const std::string& text)
+{
+	std::string escaped;
+	for (char c : text)
+	{
+		if (c == '"' || c == '\\')
+			escaped += '\\';
+		escaped += c;
+	}
+	return escaped;
+}
+
+bool BenchmarkRunner::writeJson(const std::string& path) const
+{
+	std::ofstream file(path);
+	if (!file)
+		return false;
+
+	file << "[\n";
+	for (size_t i = 0; i < m_results.size(); i++)
+	{
+		const BenchmarkResult& result = m_results[i];
+		file << "  { \"name\": \"" << escapeJson(result.name) << "\", \"params\": \""
+			<< escapeJson(result.params) << "\", \"iterations\": " << result.iterations
+			<< ", \"ns_per_op\": " << result.nsPerOp << ", \"allocs_per_op\": " << result.allocsPerOp
+			<< " }" << (i + 1 < m_results.size() ? ",\n" : "\n");
+	}
+	file << "]\n";
+	return true;
+}
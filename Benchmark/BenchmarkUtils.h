@@ -0,0 +1,79 @@
+#pragma once
+
+#include <string>
+#include <vector>
+#include <chrono>
+#include <cstdint>
+
+//Counts every heap allocation made through the global operator new in 
+//the benchmark executable
+namespace AllocCounter
+{
+	uint64_t count();
+};
+
+struct BenchmarkResult
+{
+	std::string name;
+	std::string params;
+	uint64_t iterations;
+	double nsPerOp;
+	double allocsPerOp;
+};
+
+class BenchmarkRunner
+{
+private:
+	std::vector<BenchmarkResult> m_results;
+	std::string m_filter;
+	double m_minSeconds;
+public:
+	BenchmarkRunner(const std::string& filter, double minSeconds)
+		: m_filter(filter), m_minSeconds(minSeconds) {}
+
+	bool isEnabled(const std::string& name) const;
+
+	//Times op(i) for increasing i until the minimum time has passed. Each 
+	//call to op counts as one operation
+	template<typename Op>
+	void run(const std::string& name, const std::string& params, Op op)
+	{
+		if (!isEnabled(name))
+			return;
+
+		//Warm up caches and let the op settle any lazily allocated state
+		for (uint64_t i = 0; i < 16; i++)
+			op(i);
+
+		uint64_t iterations = 0;
+		uint64_t batch = 64;
+		uint64_t allocsBefore = AllocCounter::count();
+		auto start = std::chrono::steady_clock::now();
+		double elapsed = 0.0;
+		while (elapsed < m_minSeconds)
+		{
+			for (uint64_t i = 0; i < batch; i++)
+				op(iterations + i);
+			iterations += batch;
+			batch *= 2;
+			elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+		}
+		uint64_t allocs = AllocCounter::count() - allocsBefore;
+
+		record({ name, params, iterations, elapsed * 1e9 / iterations, (double)allocs / iterations });
+	}
+
+	void record(const BenchmarkResult& result);
+	const std::vector<BenchmarkResult>& getResults() const { return m_results; }
+
+	//Writes every result as a JSON array
+	bool writeJson(const std::string& path) const;
+};
+
+//Stops the optimiser from discarding results it can prove are unused
+template<typename T>
+inline void doNotOptimise(const T& value)
+{
+	volatile const char* sink = reinterpret_cast<volatile const char*>(&value);
+	(void)*sink;
+}
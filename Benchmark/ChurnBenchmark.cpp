@@ -0,0 +1,240 @@
+#include "ChurnBenchmark.h"
+#include "BenchmarkUtils.h"
+#include "Simulation.h"
+#include "Random.h"
+
+#include <algorithm>
+#include <chrono>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <memory>
+#include <sstream>
+#include <thread>
+#define _USE_MATH_DEFINES
+#include <math.h>
+
+struct ChurnResult
+{
+	std::string key;
+	int population;
+	int rate;
+	int frames;
+	double msPerFrame;
+	//Mean step time over the first and last quarters of the run. A late
+	//figure well above the early one means churn is wearing the partition down
+	double earlyMsPerFrame;
+	double lateMsPerFrame;
+	double p99MsPerFrame;
+	//Despawn and respawn pairs, random ones and sink arrivals together
+	int churned;
+	int arrivals;
+	double nsPerChurn;
+	double allocsPerChurn;
+};
+
+static vec2 getEmitter(const ChurnOptions& options, int emitter)
+{
+	float angle = 2.0f * (float)M_PI * emitter / options.emitters;
+	return vec2(std::cos(angle), std::sin(angle)) * options.ringRadius;
+}
+
+//Adds a boid part of the way along the path from a random emitter to its sink
+static void spawnBoid(Simulation& simulation, const ChurnOptions& options, Random& random, float along)
+{
+	vec2 emitter = getEmitter(options, random.index(options.emitters));
+	vec2 sink = -emitter;
+	float jitterX = random.uniform(-5.0f, 5.0f);
+	float jitterY = random.uniform(-5.0f, 5.0f);
+	vec2 position = emitter + (sink - emitter) * along + vec2(jitterX, jitterY);
+
+	Handle boid = simulation.addBoid(position, (sink - emitter).unit());
+	simulation.getBoids().homeLocation[simulation.findBoid(boid)] = sink;
+}
+
+//Mean of frame times [begin, end)
+static double meanMs(const std::vector<double>& frameMs, int begin, int end)
+{
+	if (end <= begin)
+		return 0.0;
+	double total = 0.0;
+	for (int i = begin; i < end; i++)
+		total += frameMs[i];
+	return total / (end - begin);
+}
+
+static ChurnResult runConfiguration(const ChurnOptions& options, int population, int rate)
+{
+	//Destinations are per boid, so the home distance only sets how close
+	//boids try to get to their sink
+	ActorSettings settings;
+	settings.homeDist = options.sinkRadius * 0.5f;
+
+	//Same cell width as the app
+	std::unique_ptr<Simulation> simulation(new Simulation(10.0f));
+	simulation->applySettings(settings);
+	Random random(options.seed);
+	for (int i = 0; i < population; i++)
+		spawnBoid(*simulation, options, random, random.uniform());
+
+	ChurnResult result;
+	std::ostringstream key;
+	key << "churn n=" << population << " rate=" << rate;
+	result.key = key.str();
+	result.population = population;
+	result.rate = rate;
+	result.churned = 0;
+	result.arrivals = 0;
+
+	std::vector<double> frameMs;
+	frameMs.reserve(options.maxFrames);
+	std::vector<Handle> arrived;
+	double churnSeconds = 0.0;
+	uint64_t churnAllocs = 0;
+	for (int frame = 0; frame < options.maxFrames; frame++)
+	{
+		//Finding the arrivals isn't timed, only the despawns and respawns
+		const BoidStore& boids = simulation->getBoids();
+		arrived.clear();
+		for (int i = 0; i < boids.size(); i++)
+		{
+			if ((boids.homeLocation[i] - boids.position[i]).mag() <= options.sinkRadius)
+				arrived.push_back(boids.handles.getHandle(i));
+		}
+
+		uint64_t allocsBefore = AllocCounter::count();
+		auto churnStart = std::chrono::steady_clock::now();
+		for (Handle boid : arrived)
+		{
+			simulation->removeBoid(boid);
+			spawnBoid(*simulation, options, random, 0.0f);
+		}
+		for (int i = 0; i < rate && boids.size() > 0; i++)
+		{
+			simulation->removeBoid(boids.handles.getHandle(random.index(boids.size())));
+			spawnBoid(*simulation, options, random, 0.0f);
+		}
+		churnSeconds += std::chrono::duration<double>(std::chrono::steady_clock::now() - churnStart).count();
+		churnAllocs += AllocCounter::count() - allocsBefore;
+		result.arrivals += (int)arrived.size();
+		result.churned += (int)arrived.size() + rate;
+
+		auto start = std::chrono::steady_clock::now();
+		simulation->step(1.0f);
+		frameMs.push_back(std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count());
+	}
+
+	int frames = (int)frameMs.size();
+	result.frames = frames;
+	result.msPerFrame = meanMs(frameMs, 0, frames);
+	result.earlyMsPerFrame = meanMs(frameMs, 0, frames / 4);
+	result.lateMsPerFrame = meanMs(frameMs, frames - frames / 4, frames);
+	std::vector<double> sorted = frameMs;
+	std::sort(sorted.begin(), sorted.end());
+	result.p99MsPerFrame = sorted.empty() ? 0.0 : sorted[std::min(frames - 1, (int)(frames * 0.99))];
+	result.nsPerChurn = result.churned > 0 ? churnSeconds * 1e9 / result.churned : 0.0;
+	result.allocsPerChurn = result.churned > 0 ? (double)churnAllocs / result.churned : 0.0;
+	return result;
+}
+
+//Sends a small flock a long way at speed in one partition mode and checks 
+//the cell table never holds more than the partition lets build up behind 
+//it. Returns the most cells stored after any frame, or -1 past the bound
+static int runDriftCheck(const ChurnOptions& options, PartitionMode mode)
+{
+	Scenario scenario;
+	scenario.seed = options.seed;
+	scenario.numBoids = 500;
+	scenario.numObstacles = 0;
+	scenario.extent = 50.0f;
+	ActorSettings settings;
+	settings.speed = 10.0f;
+	settings.homeDist = 1.0f;
+	settings.homeLocation = vec2(1.0e5f, 0.0f);
+
+	std::unique_ptr<Simulation> simulation(new Simulation(10.0f));
+	simulation->fillEntities(scenario);
+	simulation->applySettings(settings);
+	simulation->setPartitionMode(mode);
+	int bound = 2 * scenario.numBoids + SpacePartition::spareCells;
+	int peak = 0;
+	for (int frame = 0; frame < options.maxFrames; frame++)
+	{
+		simulation->step(1.0f);
+		peak = std::max(peak, simulation->getPartition().getStoredCells());
+		if (peak > bound)
+			return -1;
+	}
+	return peak;
+}
+
+static bool writeJson(const std::string& path, const ChurnOptions& options,
+	const std::vector<ChurnResult>& results)
+{
+	std::ofstream file(path);
+	if (!file)
+		return false;
+
+	file << "{\n  \"seed\": " << options.seed << ",\n  \"hardware_threads\": "
+		<< std::thread::hardware_concurrency() << ",\n  \"results\": [\n";
+	for (size_t i = 0; i < results.size(); i++)
+	{
+		const ChurnResult& r = results[i];
+		//One result per line, matching the scaling suite
+		file << "    { \"key\": \"" << r.key << "\", \"population\": " << r.population << ", \"rate\": " << r.rate
+			<< ", \"frames\": " << r.frames << ", \"ms_per_frame\": " << r.msPerFrame
+			<< ", \"early_ms_per_frame\": " << r.earlyMsPerFrame << ", \"late_ms_per_frame\": " << r.lateMsPerFrame
+			<< ", \"p99_ms_per_frame\": " << r.p99MsPerFrame << ", \"churned\": " << r.churned
+			<< ", \"arrivals\": " << r.arrivals << ", \"ns_per_churn\": " << r.nsPerChurn
+			<< ", \"allocs_per_churn\": " << r.allocsPerChurn << " }" << (i + 1 < results.size() ? ",\n" : "\n");
+	}
+	file << "  ]\n}\n";
+	return true;
+}
+
+int runChurnBenchmarks(const ChurnOptions& options)
+{
+	std::vector<ChurnResult> results;
+	std::cout << std::left << std::setw(28) << "configuration" << std::right << std::setw(8) << "frames"
+		<< std::setw(12) << "ms/frame" << std::setw(10) << "early" << std::setw(10) << "late"
+		<< std::setw(10) << "p99" << std::setw(14) << "churn/frame" << std::setw(14) << "ns/churn"
+		<< std::setw(14) << "allocs/churn" << std::endl;
+
+	for (int population : options.populations)
+	{
+		for (int rate : options.rates)
+		{
+			ChurnResult result = runConfiguration(options, population, rate);
+			std::cout << std::left << std::setw(28) << result.key << std::right << std::setw(8) << result.frames
+				<< std::fixed << std::setprecision(3) << std::setw(12) << result.msPerFrame
+				<< std::setw(10) << result.earlyMsPerFrame << std::setw(10) << result.lateMsPerFrame
+				<< std::setw(10) << result.p99MsPerFrame << std::setprecision(1)
+				<< std::setw(14) << (double)result.churned / std::max(1, result.frames)
+				<< std::setw(14) << result.nsPerChurn << std::setprecision(3) << std::setw(14) << result.allocsPerChurn
+				<< std::defaultfloat << std::setprecision(6) << std::endl;
+			results.push_back(result);
+		}
+	}
+
+	//A flock on the move must not leave a growing trail of empty cells
+	int failures = 0;
+	for (PartitionMode mode : { PartitionMode::linked, PartitionMode::sorted })
+	{
+		int peak = runDriftCheck(options, mode);
+		const char* name = mode == PartitionMode::sorted ? "sorted" : "linked";
+		if (peak < 0)
+		{
+			std::cout << "drift " << name << ": FAILED, cells stored grew past the bound" << std::endl;
+			failures++;
+		}
+		else
+			std::cout << "drift " << name << ": at most " << peak << " cells stored" << std::endl;
+	}
+
+	if (!options.jsonPath.empty() && !writeJson(options.jsonPath, options, results))
+	{
+		std::cout << "Failed to write " << options.jsonPath << std::endl;
+		return 1;
+	}
+	return failures > 0 ? 1 : 0;
+}
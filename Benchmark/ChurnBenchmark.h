@@ -0,0 +1,30 @@
+#pragma once
+
+#include <string>
+#include <vector>
+#include <cstdint>
+
+struct ChurnOptions
+{
+	//Boids alive throughout each run
+	std::vector<int> populations = { 5000, 20000 };
+	//Boids despawned at random and respawned at an emitter every frame, on
+	//top of those recycled for reaching their sink
+	std::vector<int> rates = { 0, 50, 500 };
+	//Emitters are spaced around a ring, each sending its boids to a sink
+	//on the opposite side
+	int emitters = 8;
+	float ringRadius = 150.0f;
+	//Boids this close to their sink despawn
+	float sinkRadius = 10.0f;
+	int maxFrames = 300;
+	uint32_t seed = 12345;
+	std::string jsonPath;
+};
+
+//Runs flows of boids between emitters and sinks while despawning and
+//respawning boids every frame, reporting step time early and late in the
+//run alongside the cost of each spawn and despawn. Then checks a drifting 
+//flock doesn't grow the partition's cell table without bound. Returns 
+//non-zero if a file could not be written or the check failed
+int runChurnBenchmarks(const ChurnOptions& options);
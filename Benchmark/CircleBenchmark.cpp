@@ -0,0 +1,245 @@
+#include "CircleBenchmark.h"
+#include "Simulation.h"
+
+#include <algorithm>
+#include <chrono>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <limits>
+#include <memory>
+#include <sstream>
+#include <thread>
+
+//Overlaps and closest approach seen during a single frame
+struct CollisionSample
+{
+	int boidOverlaps = 0;
+	int obstacleOverlaps = 0;
+	//Smallest surface to surface gap within each boid's avoidance distance
+	float minBoidSeparation = std::numeric_limits<float>::max();
+	float minObstacleSeparation = std::numeric_limits<float>::max();
+};
+
+struct CircleResult
+{
+	std::string key;
+	int boids;
+	int obstacles;
+	bool clearPath;
+	int frames;
+	//-1 if some boid never reached the far side within maxFrames
+	int framesToCompletion;
+	double msPerFrame;
+	//Summed over frames, so a pair overlapping for 10 frames counts 10 times
+	int boidOverlaps;
+	int obstacleOverlaps;
+	int peakBoidOverlaps;
+	float minBoidSeparation;
+	float minObstacleSeparation;
+};
+
+//Checks every boid against its neighbours through the partition and the 
+//obstacle index, counting each boid pair once
+static CollisionSample measureCollisions(Simulation& simulation)
+{
+	CollisionSample sample;
+	const SpacePartition& partition = simulation.getPartition();
+	const ObstacleIndex& obstacles = simulation.getObstacleIndex();
+
+	float maxObstacleRadius = 0.0f;
+	for (const Obstacle& obstacle : simulation.getObstacles())
+		maxObstacleRadius = std::max(maxObstacleRadius, obstacle.m_radius);
+
+	const BoidStore& boids = simulation.getBoids();
+	for (int self = 0; self < boids.size(); self++)
+	{
+		vec2 position = boids.position[self];
+		const BoidProfile& profile = boids.getProfile(self);
+		float radius = profile.radius;
+		float queryRadius = std::max(profile.avoidanceDist, radius + std::max(radius, maxObstacleRadius));
+		CellRange<2> range = partition.findCellRange(position, queryRadius);
+
+		partition.forEachCell(range, [&](const auto& cell)
+		{
+			for (int other : cell.actors)
+			{
+				if (other <= self)
+					continue;
+				float gap = (boids.position[other] - position).mag() - radius - boids.getProfile(other).radius;
+				if (gap < 0.0f)
+					sample.boidOverlaps++;
+				sample.minBoidSeparation = std::min(sample.minBoidSeparation, gap);
+			}
+		});
+		obstacles.query(position, queryRadius, [&](const auto& obstacle)
+		{
+			float gap = (obstacle.position - position).mag() - radius - obstacle.radius;
+			if (gap < 0.0f)
+				sample.obstacleOverlaps++;
+			sample.minObstacleSeparation = std::min(sample.minObstacleSeparation, gap);
+		});
+	}
+	return sample;
+}
+
+static CircleResult runConfiguration(const CircleOptions& options, int boids, int obstacles, bool clearPath)
+{
+	Scenario scenario;
+	scenario.seed = options.seed;
+	scenario.numBoids = boids;
+	scenario.numObstacles = obstacles;
+	scenario.obstacleRadius = options.obstacleRadius;
+
+	ActorSettings settings;
+	settings.useClearPath = clearPath;
+
+	//Same cell width and set up as the Circle Test button in the app
+	std::unique_ptr<Simulation> simulation(new Simulation(10.0f));
+	simulation->fillEntities(scenario);
+	simulation->applySettings(settings);
+	simulation->setUpCircle(options.obstacleRadius);
+
+	//By handle slot, as the reorder moves boids around the store. No boid is
+	//removed, so every slot stays with the boid it was given to
+	std::vector<bool> arrived;
+	int arrivedCount = 0;
+
+	CircleResult result;
+	std::ostringstream key;
+	key << "circle n=" << boids << " obstacles=" << obstacles << " rvo=" << (clearPath ? "on" : "off");
+	result.key = key.str();
+	result.boids = boids;
+	result.obstacles = obstacles;
+	result.clearPath = clearPath;
+	result.framesToCompletion = -1;
+	result.boidOverlaps = 0;
+	result.obstacleOverlaps = 0;
+	result.peakBoidOverlaps = 0;
+	result.minBoidSeparation = std::numeric_limits<float>::max();
+	result.minObstacleSeparation = std::numeric_limits<float>::max();
+
+	//Only the steps are timed, not the collision measurement
+	double elapsed = 0.0;
+	int frames = 0;
+	while (frames < options.maxFrames && arrivedCount < boids)
+	{
+		auto start = std::chrono::steady_clock::now();
+		simulation->step(1.0f);
+		elapsed += std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+		frames++;
+
+		CollisionSample sample = measureCollisions(*simulation);
+		result.boidOverlaps += sample.boidOverlaps;
+		result.obstacleOverlaps += sample.obstacleOverlaps;
+		result.peakBoidOverlaps = std::max(result.peakBoidOverlaps, sample.boidOverlaps);
+		result.minBoidSeparation = std::min(result.minBoidSeparation, sample.minBoidSeparation);
+		result.minObstacleSeparation = std::min(result.minObstacleSeparation, sample.minObstacleSeparation);
+
+		const BoidStore& flock = simulation->getBoids();
+		for (int i = 0; i < boids; i++)
+		{
+			uint32_t slot = flock.handles.getHandle(i).slot;
+			if (slot >= arrived.size())
+				arrived.resize(slot + 1, false);
+			if (!arrived[slot] && (flock.homeLocation[i] - flock.position[i]).mag() <= options.arrivalDist)
+			{
+				arrived[slot] = true;
+				arrivedCount++;
+			}
+		}
+	}
+	if (arrivedCount == boids)
+		result.framesToCompletion = frames;
+	result.frames = frames;
+	result.msPerFrame = frames > 0 ? elapsed * 1000.0 / frames : 0.0;
+	return result;
+}
+
+//Separation or JSON null if nothing ever came within range
+static void writeSeparation(std::ostream& out, float separation)
+{
+	if (separation == std::numeric_limits<float>::max())
+		out << "null";
+	else
+		out << separation;
+}
+
+static bool writeJson(const std::string& path, const CircleOptions& options,
+	const std::vector<CircleResult>& results)
+{
+	std::ofstream file(path);
+	if (!file)
+		return false;
+
+	file << "{\n  \"seed\": " << options.seed << ",\n  \"hardware_threads\": "
+		<< std::thread::hardware_concurrency() << ",\n  \"results\": [\n";
+	for (size_t i = 0; i < results.size(); i++)
+	{
+		const CircleResult& r = results[i];
+		//One result per line, matching the scaling suite
+		file << "    { \"key\": \"" << r.key << "\", \"boids\": " << r.boids << ", \"obstacles\": " << r.obstacles
+			<< ", \"rvo\": " << (r.clearPath ? "true" : "false") << ", \"frames\": " << r.frames
+			<< ", \"frames_to_completion\": ";
+		if (r.framesToCompletion >= 0)
+			file << r.framesToCompletion;
+		else
+			file << "null";
+		file << ", \"ms_per_frame\": " << r.msPerFrame << ", \"boid_overlaps\": " << r.boidOverlaps
+			<< ", \"obstacle_overlaps\": " << r.obstacleOverlaps << ", \"peak_boid_overlaps\": " << r.peakBoidOverlaps
+			<< ", \"min_boid_separation\": ";
+		writeSeparation(file, r.minBoidSeparation);
+		file << ", \"min_obstacle_separation\": ";
+		writeSeparation(file, r.minObstacleSeparation);
+		file << " }" << (i + 1 < results.size() ? ",\n" : "\n");
+	}
+	file << "  ]\n}\n";
+	return true;
+}
+
+static void printSeparation(float separation)
+{
+	if (separation == std::numeric_limits<float>::max())
+		std::cout << std::setw(10) << "n/a";
+	else
+		std::cout << std::setw(10) << separation;
+}
+
+int runCircleBenchmarks(const CircleOptions& options)
+{
+	std::vector<CircleResult> results;
+	std::cout << std::left << std::setw(36) << "configuration" << std::right << std::setw(8) << "frames"
+		<< std::setw(10) << "complete" << std::setw(12) << "ms/frame" << std::setw(12) << "boid-boid"
+		<< std::setw(12) << "boid-obst" << std::setw(8) << "peak" << std::setw(10) << "min b-b"
+		<< std::setw(10) << "min b-o" << std::endl;
+
+	for (bool clearPath : options.clearPath)
+	{
+		for (int obstacles : options.obstacleCounts)
+		{
+			for (int boids : options.boidCounts)
+			{
+				CircleResult result = runConfiguration(options, boids, obstacles, clearPath);
+				std::cout << std::left << std::setw(36) << result.key << std::right << std::setw(8) << result.frames;
+				if (result.framesToCompletion >= 0)
+					std::cout << std::setw(10) << result.framesToCompletion;
+				else
+					std::cout << std::setw(10) << "never";
+				std::cout << std::fixed << std::setprecision(3) << std::setw(12) << result.msPerFrame
+					<< std::setw(12) << result.boidOverlaps << std::setw(12) << result.obstacleOverlaps
+					<< std::setw(8) << result.peakBoidOverlaps << std::setprecision(2);
+				printSeparation(result.minBoidSeparation);
+				printSeparation(result.minObstacleSeparation);
+				std::cout << std::defaultfloat << std::setprecision(6) << std::endl;
+				results.push_back(result);
+			}
+		}
+	}
+
+	if (!options.jsonPath.empty() && !writeJson(options.jsonPath, options, results))
+	{
+		std::cout << "Failed to write " << options.jsonPath << std::endl;
+		return 1;
+	}
+	return 0;
+}
@@ -0,0 +1,23 @@
+#pragma once
+
+#include <string>
+#include <vector>
+#include <cstdint>
+
+struct CircleOptions
+{
+	std::vector<int> boidCounts = { 100, 400 };
+	std::vector<int> obstacleCounts = { 10 };
+	std::vector<bool> clearPath = { false, true };
+	float obstacleRadius = 2.0f;
+	//A boid has finished once it comes this close to the opposite side
+	float arrivalDist = 10.0f;
+	int maxFrames = 2000;
+	uint32_t seed = 12345;
+	std::string jsonPath;
+};
+
+//Runs the Circle Test (boids crossing a ring of obstacles to the opposite 
+//side) without a window, reporting speed alongside how often boids overlap
+//each other or obstacles. Returns non-zero if a file could not be written
+int runCircleBenchmarks(const CircleOptions& options);
@@ -0,0 +1,376 @@
+#include "MicroBenchmarks.h"
+#include "BenchmarkUtils.h"
+#include "Simulation.h"
+#include "ObstacleIndex.h"
+#include "CellWidthTuner.h"
+#include "ActorSteerFunctions.h"
+#include "Boid.h"
+#include "Shape.h"
+
+#include <memory>
+#include <string>
+#include <vector>
+#define _USE_MATH_DEFINES
+#include <math.h>
+
+//Half width of the synthetic flocks, a few dozen cells across at the 
+//default width
+static const float s_fixtureExtent = 200.0f;
+//Smaller for volumetric flocks so the densest stays a manageable size
+static const float s_fixtureExtent3D = 100.0f;
+//Average number of other boids within query range of each boid
+static const int s_densities[3] = { 4, 16, 64 };
+
+//A flock of uniformly spread boids sized so each boid sees roughly 
+//neighbourCount others within max(detection, avoidance) distance
+template<int D>
+static std::unique_ptr<BasicSimulation<D>> makeFixture(int neighbourCount, bool useClearPath)
+{
+	ActorSettings settings;
+	settings.useClearPath = useClearPath;
+	float queryRadius = std::max(settings.detectionDist, settings.avoidanceDist);
+	float extent = D == 3 ? s_fixtureExtent3D : s_fixtureExtent;
+	float volume = std::pow(2.0f * extent, (float)D);
+	float queryVolume = D == 3 ? 4.0f / 3.0f * M_PI * std::pow(queryRadius, 3.0f) :
+		M_PI * queryRadius * queryRadius;
+
+	Scenario scenario;
+	scenario.seed = 12345;
+	scenario.extent = extent;
+	scenario.numBoids = (int)(neighbourCount * volume / queryVolume);
+	scenario.numObstacles = scenario.numBoids / 50;
+
+	std::unique_ptr<BasicSimulation<D>> simulation(new BasicSimulation<D>(10.0f));
+	simulation->fillEntities(scenario);
+	simulation->applySettings(settings);
+	return simulation;
+}
+
+template<int D>
+static std::string densityParams(int neighbourCount, const BasicSimulation<D>& simulation)
+{
+	return "k=" + std::to_string(neighbourCount) + " n=" + std::to_string(simulation.getBoids().size());
+}
+
+//Builds the edge list of a convex polygon the same way Shape does internally
+static std::vector<Shape::Line> makeLines(const std::vector<vec2>& points)
+{
+	std::vector<Shape::Line> lines;
+	vec2 lastPoint = points.back();
+	for (vec2 point : points)
+	{
+		vec2 diff = point - lastPoint;
+		lines.emplace_back(lastPoint, atan2(diff.y, diff.x), diff.mag());
+		lastPoint = point;
+	}
+	return lines;
+}
+
+static void runSteeringBenchmarks(BenchmarkRunner& runner)
+{
+	for (int density : s_densities)
+	{
+		std::unique_ptr<Simulation> simulation = makeFixture<2>(density, true);
+		const BoidStore& boids = simulation->getBoids();
+		const ObstacleIndex& obstacles = simulation->getObstacleIndex();
+		const SpacePartition& partition = simulation->getPartition();
+		GridIndex<2> grid(partition);
+		std::string params = densityParams(density, *simulation);
+
+		runner.run("ASF::actorDataCollection", params, [&](uint64_t i)
+		{
+			vec2 sumPos, sumVel, sumCol;
+			ASF::actorDataCollection(sumPos, sumVel, sumCol, boids, (int)(i % boids.size()), obstacles, 
+				grid);
+			doNotOptimise(sumCol);
+		});
+
+		//Rewound every op as steering does for every boid
+		FrameArena arena;
+		runner.run("ASF::velocityObstacleCollection", params, [&](uint64_t i)
+		{
+			FrameArena::Scope scratch(arena);
+			ASF::ShapeList velObst{ ArenaAllocator<Shape>(arena) };
+			ASF::velocityObstacleCollection(boids, (int)(i % boids.size()), obstacles, velObst, grid);
+			doNotOptimise(velObst.size());
+		});
+
+		//Everything one boid does per frame with clear path on. Its temporaries 
+		//come from the arena, so this should make no heap allocations
+		runner.run("Boid::steering", params, [&](uint64_t i)
+		{
+			int b = (int)(i % boids.size());
+			Boid::steering<2>(simulation->getBoids(), b, b + 1, obstacles, grid, arena);
+		});
+
+		//Same queries walking contiguous runs of a counting sorted partition
+		simulation->setPartitionMode(PartitionMode::sorted);
+		runner.run("ASF::actorDataCollection sorted", params, [&](uint64_t i)
+		{
+			vec2 sumPos, sumVel, sumCol;
+			ASF::actorDataCollection(sumPos, sumVel, sumCol, boids, (int)(i % boids.size()), obstacles, 
+				grid);
+			doNotOptimise(sumCol);
+		});
+		simulation->setPartitionMode(PartitionMode::linked);
+
+		//Same queries through the trees, built once up front
+		KdTree kdTree;
+		kdTree.build(boids.position);
+		runner.run("ASF::actorDataCollection kdtree", params, [&](uint64_t i)
+		{
+			vec2 sumPos, sumVel, sumCol;
+			ASF::actorDataCollection(sumPos, sumVel, sumCol, boids, (int)(i % boids.size()), obstacles, 
+				kdTree);
+			doNotOptimise(sumCol);
+		});
+		AabbTree aabbTree;
+		aabbTree.build(boids.position);
+		runner.run("ASF::actorDataCollection bvh", params, [&](uint64_t i)
+		{
+			vec2 sumPos, sumVel, sumCol;
+			ASF::actorDataCollection(sumPos, sumVel, sumCol, boids, (int)(i % boids.size()), obstacles, 
+				aabbTree);
+			doNotOptimise(sumCol);
+		});
+
+		//Packs the whole flock per op. Snaps the fixture to the packed 
+		//values, which is why it comes after the full float cases
+		CompactBoidStore compact;
+		runner.run("CompactBoidStore::quantize", params, [&](uint64_t)
+		{
+			compact.quantize(simulation->getBoids(), simulation->getPartition());
+			doNotOptimise(compact[0]);
+		});
+
+		//Filled even if the quantize case was filtered out
+		compact.quantize(simulation->getBoids(), simulation->getPartition());
+		runner.run("ASF::actorDataCollection compact", params, [&](uint64_t i)
+		{
+			vec2 sumPos, sumVel, sumCol;
+			ASF::actorDataCollection(sumPos, sumVel, sumCol, boids, (int)(i % boids.size()), obstacles, 
+				grid, &compact);
+			doNotOptimise(sumCol);
+		});
+
+		if (!runner.isEnabled("ASF::clearPathSampling"))
+			continue;
+
+		//Sampling only reads the VOs, so gather them once up front
+		int sampled = std::min(boids.size(), 256);
+		std::vector<ASF::ShapeList> velObsts;
+		velObsts.reserve(sampled);
+		for (int b = 0; b < sampled; b++)
+		{
+			velObsts.emplace_back(ArenaAllocator<Shape>(arena));
+			ASF::velocityObstacleCollection(boids, b, obstacles, velObsts[b], grid);
+		}
+
+		runner.run("ASF::clearPathSampling", params, [&](uint64_t i)
+		{
+			int b = (int)(i % sampled);
+			vec2 velocity = boids.velocity[b];
+			vec2 target = vec2(-velocity.y, velocity.x).unit();
+			vec2 result = ASF::clearPathSampling(target, velocity, 
+				boids.getProfile(b).maxSpeed, velObsts[b]);
+			doNotOptimise(result);
+		});
+	}
+
+	//Same neighbour counts in a volumetric flock, for comparison with the 
+	//planar build
+	for (int density : s_densities)
+	{
+		std::unique_ptr<Simulation3D> simulation = makeFixture<3>(density, false);
+		const BoidStore3D& boids = simulation->getBoids();
+		const ObstacleIndex3D& obstacles = simulation->getObstacleIndex();
+		const SpacePartition3D& partition = simulation->getPartition();
+		GridIndex<3> grid(partition);
+
+		runner.run("ASF::actorDataCollection 3D", densityParams(density, *simulation), [&](uint64_t i)
+		{
+			vec3 sumPos, sumVel, sumCol;
+			ASF::actorDataCollection(sumPos, sumVel, sumCol, boids, (int)(i % boids.size()), obstacles, 
+				grid);
+			doNotOptimise(sumCol);
+		});
+	}
+}
+
+static void runPartitionBenchmarks(BenchmarkRunner& runner)
+{
+	for (int density : s_densities)
+	{
+		std::unique_ptr<Simulation> simulation = makeFixture<2>(density, false);
+		BoidStore& boids = simulation->getBoids();
+		SpacePartition& partition = simulation->getPartition();
+		std::string params = densityParams(density, *simulation);
+
+		//Every op moves a boid into the neighbouring cell and so always 
+		//takes the list remove/insert path
+		runner.run("SpacePartition::haveMoved cross-cell", params, [&](uint64_t i)
+		{
+			int boid = (int)(i % boids.size());
+			vec2 oldPosition = boids.position[boid];
+			float step = (i / boids.size()) % 2 == 0 ? 10.0f : -10.0f;
+			boids.position[boid] = oldPosition + vec2(step, 0.0f);
+			partition.haveMoved(boid, boids.position[boid]);
+		});
+
+		runner.run("SpacePartition::haveMoved same-cell", params, [&](uint64_t i)
+		{
+			int boid = (int)(i % boids.size());
+			partition.haveMoved(boid, boids.position[boid]);
+		});
+
+		runner.run("SpacePartition::findCellRange", params, [&](uint64_t i)
+		{
+			int boid = (int)(i % boids.size());
+			CellRange<2> range = partition.findCellRange(boids.position[boid], 
+				boids.getProfile(boid).queryRadius);
+			doNotOptimise(range);
+		});
+
+		//One sample of the flock's queries, which the tuner takes every 
+		//interval, and the frame's slice of the refile that follows when it 
+		//picks a new width, flipping between two widths as each one finishes
+		CellWidthTuner tuner;
+		tuner.setInterval(1);
+		runner.run("CellWidthTuner::update", params, [&](uint64_t)
+		{
+			doNotOptimise(tuner.update(boids, partition));
+		});
+		runner.run("SpacePartition::migrateActors", params, [&](uint64_t)
+		{
+			if (!partition.isMigrating())
+				partition.setPartitionWidth(partition.getPartitionWidth() == 10.0f ? 12.0f : 10.0f);
+			partition.migrateActors(boids.position, boids.size() / 8 + 1);
+		});
+		partition.setPartitionWidth(10.0f);
+		while (partition.isMigrating())
+			partition.migrateActors(boids.position, boids.size());
+
+		//Despawns a random boid and spawns a replacement, so each op pays for 
+		//a handle lookup, a swap-remove and refiling the boid that filled the gap
+		Random random(99);
+		std::vector<Handle> handles;
+		for (int b = 0; b < boids.size(); b++)
+			handles.push_back(boids.handles.getHandle(b));
+		runner.run("Simulation::removeBoid+addBoid", params, [&](uint64_t)
+		{
+			Handle& handle = handles[random.index((int)handles.size())];
+			int boid = simulation->findBoid(handle);
+			vec2 position = boids.position[boid];
+			vec2 velocity = boids.velocity[boid];
+			simulation->removeBoid(handle);
+			handle = simulation->addBoid(position, velocity);
+		});
+
+		//Bins the whole flock per op, which sorted mode does once a frame in 
+		//place of every haveMoved
+		simulation->setPartitionMode(PartitionMode::sorted);
+		runner.run("SpacePartition::rebuildActors", params, [&](uint64_t)
+		{
+			partition.rebuildActors(boids.position);
+		});
+
+		//What each tree costs per frame in place of the partition's upkeep. 
+		//Every op nudges one boid out of its BVH leaf before updating, a 
+		//light frame for a flock in which only a few boids leave their boxes
+		KdTree kdTree;
+		runner.run("KdTree::build", params, [&](uint64_t)
+		{
+			kdTree.build(boids.position);
+			doNotOptimise(kdTree.getNodeCount());
+		});
+		AabbTree aabbTree;
+		runner.run("AabbTree::build", params, [&](uint64_t)
+		{
+			aabbTree.build(boids.position);
+			doNotOptimise(aabbTree.getHeight());
+		});
+		aabbTree.build(boids.position);
+		runner.run("AabbTree::update one moved", params, [&](uint64_t i)
+		{
+			int boid = (int)(i % boids.size());
+			float step = (i / boids.size()) % 2 == 0 ? 10.0f : -10.0f;
+			boids.position[boid] = boids.position[boid] + vec2(step, 0.0f);
+			aabbTree.update(boids.position);
+		});
+
+		//Paid whenever an obstacle is added, removed or resized
+		ObstacleIndex obstacleIndex;
+		runner.run("ObstacleIndex::build", params, [&](uint64_t)
+		{
+			obstacleIndex.build(simulation->getObstacles(), partition.getPartitionWidth());
+			doNotOptimise(obstacleIndex.getEntryCount());
+		});
+	}
+}
+
+static void runShapeBenchmarks(BenchmarkRunner& runner)
+{
+	const float radius = 2.0f;
+	const float avoidDist = 20.0f;
+	Random random(2024);
+
+	//A ring of relative positions and velocities to build VOs from
+	const int count = 256;
+	std::vector<vec2> offsets, velocities;
+	for (int i = 0; i < count; i++)
+	{
+		float angle = random.uniform(0.0f, 2 * M_PI);
+		float dist = random.uniform(2.5f * radius, avoidDist);
+		offsets.push_back(vec2(cos(angle) * dist, sin(angle) * dist));
+		velocities.push_back(vec2(random.uniform(-1.0f, 1.0f), random.uniform(-1.0f, 1.0f)));
+	}
+
+	runner.run("Shape::addConeSection", "", [&](uint64_t i)
+	{
+		Shape shape(velocities[i % count]);
+		shape.addConeSection(offsets[i % count], radius, radius, avoidDist * 10.0f);
+		doNotOptimise(shape);
+	});
+
+	//Each op includes building the cone shape the square is added to
+	std::vector<std::vector<Shape::Line>> cones, squares;
+	for (int i = 0; i < count; i++)
+	{
+		vec2 dir = velocities[i].unit() * radius;
+		squares.push_back(makeLines({ vec2(dir.x, dir.y), vec2(dir.y, -dir.x),
+			vec2(-dir.x, -dir.y), vec2(-dir.y, dir.x) }));
+		vec2 o = offsets[i];
+		vec2 perp = vec2(-o.y, o.x).unit() * radius;
+		cones.push_back(makeLines({ o - perp, (o - perp) * 10.0f, (o + perp) * 10.0f, o + perp }));
+	}
+	runner.run("Shape::minkowskySum", "incl. cone setup", [&](uint64_t i)
+	{
+		const std::vector<Shape::Line>& cone = cones[i % count];
+		const std::vector<Shape::Line>& square = squares[i % count];
+		Shape shape(velocities[i % count], cone.data(), (int)cone.size());
+		shape.minkowskySum(square.data(), (int)square.size());
+		doNotOptimise(shape);
+	});
+
+	std::vector<Shape> shapes;
+	std::vector<vec2> points;
+	for (int i = 0; i < count; i++)
+	{
+		shapes.emplace_back(velocities[i] / 2);
+		shapes.back().addConeSection(offsets[i], radius, radius, avoidDist * 10.0f);
+		shapes.back().addSquare(velocities[i].unit(), radius);
+		points.push_back(vec2(random.uniform(-1.0f, 1.0f), random.uniform(-1.0f, 1.0f)));
+	}
+	runner.run("Shape::isPointInside", "", [&](uint64_t i)
+	{
+		bool inside = shapes[i % count].isPointInside(points[(i * 7) % count]);
+		doNotOptimise(inside);
+	});
+}
+
+void runMicroBenchmarks(BenchmarkRunner& runner)
+{
+	runSteeringBenchmarks(runner);
+	runPartitionBenchmarks(runner);
+	runShapeBenchmarks(runner);
+}
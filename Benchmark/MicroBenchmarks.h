@@ -0,0 +1,7 @@
+#pragma once
+
+class BenchmarkRunner;
+
+//Benchmarks the individual steering kernels, partition operations and 
+//shape geometry on synthetic flocks of controlled neighbour density
+void runMicroBenchmarks(BenchmarkRunner& runner);
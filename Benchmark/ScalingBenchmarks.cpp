@@ -0,0 +1,496 @@
+#include "ScalingBenchmarks.h"
+#include "Simulation.h"
+#include "PerfCounters.h"
+#include "Profiler.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <map>
+#include <memory>
+#include <sstream>
+#include <thread>
+
+//Settings shared by every size in a run of the scaling suite
+struct ScalingSeries
+{
+	int threads;
+	bool clearPath;
+	bool compact;
+	bool sorted;
+	SpatialIndexType index;
+	SpawnPattern pattern;
+	float detect;
+	float avoid;
+};
+
+struct ScalingResult
+{
+	std::string key;
+	//Key with the index left out, shared by the runs that only differ by index
+	std::string scenario;
+	int boids;
+	int threads;
+	bool clearPath;
+	bool compact;
+	bool sorted;
+	SpatialIndexType index;
+	SpawnPattern pattern;
+	float detectionDist;
+	float avoidanceDist;
+	int frames;
+	double msPerFrame;
+	double nsPerBoidFrame;
+	//log(time ratio) / log(size ratio) against the previous size with the 
+	//same settings. Around 1 is linear, around 2 means the neighbour search 
+	//has gone quadratic
+	double exponent;
+	//Distance between where each boid ended up in the compact run and in a 
+	//full float run of the same frames, and the angle between its headings 
+	//in degrees. Zero for full float runs
+	double meanDrift;
+	double maxDrift;
+	double meanHeadingDrift;
+	//Hardware counter totals over the timed frames, if they were available
+	PerfCounters::Sample counters;
+	//Profiler work counters averaged per frame, all zero unless BOIDS_PROFILING is on
+	float workCounts[(int)ProfileCounter::count];
+
+	float getWorkCount(ProfileCounter counter) const { return workCounts[(int)counter]; }
+};
+
+//Neighbour query counters written as <name>_visited/_accepted per boid per frame
+struct QueryCounterNames
+{
+	const char* name;
+	ProfileCounter visited;
+	ProfileCounter accepted;
+};
+
+static const QueryCounterNames s_queryCounters[] = {
+	{ "collect_from_actors", ProfileCounter::actorCandidates, ProfileCounter::actorsAccepted },
+	{ "collect_from_obstacles", ProfileCounter::obstacleCandidates, ProfileCounter::obstaclesAccepted },
+	{ "get_actor_vos", ProfileCounter::actorVOCandidates, ProfileCounter::actorVOsBuilt },
+	{ "get_obstacle_vos", ProfileCounter::obstacleVOCandidates, ProfileCounter::obstacleVOsBuilt },
+};
+
+//Velocity obstacles built per boid that gathered them
+static float getVOsPerBoid(const ScalingResult& result)
+{
+	float collections = result.getWorkCount(ProfileCounter::voCollections);
+	if (collections <= 0.0f)
+		return 0.0f;
+	return (result.getWorkCount(ProfileCounter::actorVOsBuilt) + 
+		result.getWorkCount(ProfileCounter::obstacleVOsBuilt)) / collections;
+}
+
+//Defaults are left out of keys so older baselines still match
+static std::string makeKey(int boids, const ScalingSeries& series, bool withIndex)
+{
+	std::ostringstream key;
+	key << "n=" << boids << " threads=" << series.threads << " rvo=" << (series.clearPath ? "on" : "off")
+		<< (series.compact ? " compact=on" : "") << (series.sorted ? " partition=sorted" : "");
+	if (series.pattern != SpawnPattern::uniformBox)
+		key << " pattern=" << getPatternName(series.pattern);
+	if (withIndex && series.index != SpatialIndexType::grid)
+		key << " index=" << getSpatialIndexName(series.index);
+	key << " detect=" << series.detect << " avoid=" << series.avoid;
+	return key.str();
+}
+
+//Every combination of the options besides size, in the order they're run
+static std::vector<ScalingSeries> makeSeries(const ScalingOptions& options)
+{
+	std::vector<ScalingSeries> series;
+	for (const std::pair<float, float>& radii : options.radii)
+		for (SpawnPattern pattern : options.patterns)
+			for (bool clearPath : options.clearPath)
+				for (bool compact : options.compact)
+					for (bool sorted : options.sortedPartition)
+						for (SpatialIndexType index : options.indices)
+							for (int threads : options.threads)
+								series.push_back({ threads, clearPath, compact, sorted, index, pattern, radii.first, radii.second });
+	return series;
+}
+
+static std::unique_ptr<Simulation> createSimulation(const ScalingOptions& options, int boids, 
+	const ScalingSeries& series, bool compact)
+{
+	Scenario scenario;
+	scenario.seed = options.seed;
+	scenario.pattern = series.pattern;
+	scenario.numBoids = boids;
+	scenario.numObstacles = boids / 100;
+	scenario.extent = 0.0f;
+
+	//Cells as wide as the query radius, so each query covers at most 3x3
+	ScenarioGenerator sizing(scenario);
+	float cellWidth = std::max(10.0f, std::max(series.detect, series.avoid));
+
+	ActorSettings settings;
+	settings.detectionDist = series.detect;
+	settings.avoidanceDist = series.avoid;
+	settings.useClearPath = series.clearPath;
+	settings.homeDist = sizing.getExtent();
+
+	std::unique_ptr<Simulation> simulation(new Simulation(cellWidth));
+	simulation->fillEntities(scenario);
+	simulation->applySettings(settings);
+	simulation->setThreadCount(series.threads);
+	simulation->setCompactState(compact);
+	if (series.sorted)
+		simulation->setPartitionMode(PartitionMode::sorted);
+	simulation->setSpatialIndex(series.index);
+	return simulation;
+}
+
+//Compares boids by handle, as the two runs may have reordered them differently
+static void measureDrift(const Simulation& compact, const Simulation& reference, ScalingResult& result)
+{
+	const BoidStore& quantised = compact.getBoids();
+	const BoidStore& full = reference.getBoids();
+	double totalDistance = 0.0;
+	double totalAngle = 0.0;
+	int compared = 0;
+	for (int i = 0; i < quantised.size(); i++)
+	{
+		int other = reference.findBoid(quantised.handles.getHandle(i));
+		if (other < 0)
+			continue;
+		double distance = (quantised.position[i] - full.position[other]).mag();
+		vec2 a = quantised.velocity[i].unit();
+		vec2 b = full.velocity[other].unit();
+		double angle = std::atan2(a.cross(b), a.dot(b));
+		totalDistance += distance;
+		totalAngle += std::fabs(angle);
+		result.maxDrift = std::max(result.maxDrift, distance);
+		compared++;
+	}
+	if (compared > 0)
+	{
+		result.meanDrift = totalDistance / compared;
+		result.meanHeadingDrift = totalAngle / compared * 180.0 / 3.14159265358979;
+	}
+}
+
+static ScalingResult runConfiguration(const ScalingOptions& options, int boids, const ScalingSeries& series)
+{
+	//Opened before the worker threads start so that they inherit the counters
+	PerfCounters counters;
+	if (options.usePerf)
+		counters.open();
+
+	std::unique_ptr<Simulation> simulation = createSimulation(options, boids, series, series.compact);
+
+	for (int i = 0; i < options.warmupFrames; i++)
+		simulation->step(1.0f);
+
+	Profiler::get().reset();
+	int frames = 0;
+	double elapsed = 0.0;
+	PerfCounters::Sample countersBefore = counters.read();
+	auto start = std::chrono::steady_clock::now();
+	while (frames < std::max(1, options.maxFrames) && (frames == 0 || elapsed < options.maxSeconds))
+	{
+		simulation->step(1.0f);
+		Profiler::get().endFrame();
+		frames++;
+		elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+	}
+	PerfCounters::Sample countersAfter = counters.read();
+
+	ScalingResult result;
+	result.key = makeKey(boids, series, true);
+	result.scenario = makeKey(boids, series, false);
+	result.boids = boids;
+	result.threads = simulation->getThreadCount();
+	result.clearPath = series.clearPath;
+	result.compact = series.compact;
+	result.sorted = series.sorted;
+	result.index = series.index;
+	result.pattern = series.pattern;
+	result.detectionDist = series.detect;
+	result.avoidanceDist = series.avoid;
+	result.frames = frames;
+	result.msPerFrame = elapsed * 1000.0 / frames;
+	result.nsPerBoidFrame = elapsed * 1e9 / ((double)frames * std::max(1, boids));
+	result.exponent = 0.0;
+	result.counters = countersAfter - countersBefore;
+	for (int i = 0; i < (int)ProfileCounter::count; i++)
+		result.workCounts[i] = Profiler::get().getCounterStats((ProfileCounter)i).average;
+
+	result.meanDrift = 0.0;
+	result.maxDrift = 0.0;
+	result.meanHeadingDrift = 0.0;
+	if (series.compact)
+	{
+		//Untimed, stepped the same number of frames as the timed run
+		std::unique_ptr<Simulation> reference = createSimulation(options, boids, series, false);
+		for (int i = 0; i < options.warmupFrames + frames; i++)
+			reference->step(1.0f);
+		measureDrift(*simulation, *reference, result);
+	}
+	return result;
+}
+
+//Fastest index on one scenario, out of those run
+struct BestIndex
+{
+	std::string scenario;
+	SpatialIndexType index;
+	double msPerFrame;
+	//Zero if the grid wasn't run
+	double gridMsPerFrame;
+	int indicesRun;
+};
+
+//Groups the results that only differ by index, in the order first run
+static std::vector<BestIndex> findBestIndices(const std::vector<ScalingResult>& results)
+{
+	std::vector<BestIndex> best;
+	std::map<std::string, int> byScenario;
+	for (const ScalingResult& result : results)
+	{
+		auto found = byScenario.find(result.scenario);
+		if (found == byScenario.end())
+		{
+			found = byScenario.emplace(result.scenario, (int)best.size()).first;
+			best.push_back({ result.scenario, result.index, result.msPerFrame, 0.0, 0 });
+		}
+		BestIndex& entry = best[found->second];
+		entry.indicesRun++;
+		if (result.msPerFrame < entry.msPerFrame)
+		{
+			entry.index = result.index;
+			entry.msPerFrame = result.msPerFrame;
+		}
+		if (result.index == SpatialIndexType::grid)
+			entry.gridMsPerFrame = result.msPerFrame;
+	}
+	return best;
+}
+
+//Only printed when more than one index was run
+static void printBestIndices(const std::vector<ScalingResult>& results)
+{
+	std::vector<BestIndex> best = findBestIndices(results);
+	if (best.empty() || best[0].indicesRun < 2)
+		return;
+
+	std::cout << std::endl << "Fastest index per scenario" << std::endl;
+	for (const BestIndex& entry : best)
+	{
+		std::cout << std::left << std::setw(76) << entry.scenario << std::setw(8) << getSpatialIndexName(entry.index)
+			<< std::right << std::fixed << std::setprecision(3) << std::setw(14) << entry.msPerFrame;
+		if (entry.gridMsPerFrame > 0.0)
+			std::cout << std::setprecision(2) << std::setw(10) << entry.gridMsPerFrame / entry.msPerFrame << "x grid";
+		std::cout << std::endl;
+	}
+}
+
+//Counter value per boid per frame, or JSON null when unavailable
+static void writeCounter(std::ostream& out, const ScalingResult& result, PerfCounter counter)
+{
+	if (result.counters.valid[(int)counter])
+		out << result.counters.values[(int)counter] / ((double)result.frames * std::max(1, result.boids));
+	else
+		out << "null";
+}
+
+static bool writeJson(const std::string& path, const ScalingOptions& options,
+	const std::vector<ScalingResult>& results)
+{
+	std::ofstream file(path);
+	if (!file)
+		return false;
+
+	file << "{\n  \"seed\": " << options.seed << ",\n  \"hardware_threads\": "
+		<< std::thread::hardware_concurrency() << ",\n  \"results\": [\n";
+	for (size_t i = 0; i < results.size(); i++)
+	{
+		const ScalingResult& r = results[i];
+		//One result per line, which is what readBaseline expects
+		file << "    { \"key\": \"" << r.key << "\", \"boids\": " << r.boids << ", \"threads\": " << r.threads
+			<< ", \"rvo\": " << (r.clearPath ? "true" : "false") << ", \"compact\": " << (r.compact ? "true" : "false")
+			<< ", \"partition\": \"" << (r.sorted ? "sorted" : "linked") << "\""
+			<< ", \"index\": \"" << getSpatialIndexName(r.index) << "\""
+			<< ", \"pattern\": \"" << getPatternName(r.pattern) << "\""
+			<< ", \"detect\": " << r.detectionDist
+			<< ", \"avoid\": " << r.avoidanceDist << ", \"frames\": " << r.frames
+			<< ", \"ms_per_frame\": " << r.msPerFrame << ", \"ns_per_boid_frame\": " << r.nsPerBoidFrame
+			<< ", \"exponent\": " << r.exponent;
+		if (r.compact)
+			file << ", \"drift_mean\": " << r.meanDrift << ", \"drift_max\": " << r.maxDrift
+				<< ", \"heading_drift_deg\": " << r.meanHeadingDrift;
+		if (options.usePerf)
+		{
+			const double* values = r.counters.values;
+			file << ", \"ipc\": ";
+			if (r.counters.valid[(int)PerfCounter::cycles] && r.counters.valid[(int)PerfCounter::instructions] &&
+				values[(int)PerfCounter::cycles] > 0.0)
+				file << values[(int)PerfCounter::instructions] / values[(int)PerfCounter::cycles];
+			else
+				file << "null";
+			file << ", \"cache_misses_per_boid\": ";
+			writeCounter(file, r, PerfCounter::cacheMisses);
+			file << ", \"branch_misses_per_boid\": ";
+			writeCounter(file, r, PerfCounter::branchMisses);
+			file << ", \"llc_loads_per_boid\": ";
+			writeCounter(file, r, PerfCounter::llcLoads);
+		}
+#if BOIDS_PROFILING
+		double perBoid = 1.0 / std::max(1, r.boids);
+		for (const QueryCounterNames& query : s_queryCounters)
+			file << ", \"" << query.name << "_visited_per_boid\": " << r.getWorkCount(query.visited) * perBoid
+				<< ", \"" << query.name << "_accepted_per_boid\": " << r.getWorkCount(query.accepted) * perBoid;
+		file << ", \"vos_per_boid\": " << getVOsPerBoid(r);
+#endif
+		file << " }" << (i + 1 < results.size() ? ",\n" : "\n");
+	}
+	file << "  ]";
+
+	//Keyed by scenario rather than key so readBaseline skips them
+	std::vector<BestIndex> best = findBestIndices(results);
+	if (!best.empty() && best[0].indicesRun > 1)
+	{
+		file << ",\n  \"best\": [\n";
+		for (size_t i = 0; i < best.size(); i++)
+		{
+			const BestIndex& b = best[i];
+			file << "    { \"scenario\": \"" << b.scenario << "\", \"index\": \"" << getSpatialIndexName(b.index)
+				<< "\", \"ms_per_frame\": " << b.msPerFrame << ", \"grid_ms_per_frame\": " << b.gridMsPerFrame
+				<< " }" << (i + 1 < best.size() ? ",\n" : "\n");
+		}
+		file << "  ]";
+	}
+	file << "\n}\n";
+	return true;
+}
+
+//Reads key -> ms_per_frame from a file written by writeJson
+static bool readBaseline(const std::string& path, std::map<std::string, double>& baseline)
+{
+	std::ifstream file(path);
+	if (!file)
+		return false;
+
+	std::string line;
+	while (std::getline(file, line))
+	{
+		size_t keyPos = line.find("\"key\": \"");
+		size_t timePos = line.find("\"ms_per_frame\": ");
+		if (keyPos == std::string::npos || timePos == std::string::npos)
+			continue;
+		keyPos += 8;
+		std::string key = line.substr(keyPos, line.find('"', keyPos) - keyPos);
+		baseline[key] = std::atof(line.c_str() + timePos + 16);
+	}
+	return true;
+}
+
+int runScalingBenchmarks(const ScalingOptions& options)
+{
+	if (options.usePerf)
+	{
+		PerfCounters probe;
+		if (!probe.open())
+			std::cout << "Hardware counters unavailable (" << probe.getError() << "), reporting timings only" << std::endl;
+	}
+
+	bool reportDrift = std::find(options.compact.begin(), options.compact.end(), true) != options.compact.end();
+	std::vector<ScalingResult> results;
+	std::cout << std::left << std::setw(76) << "configuration" << std::right << std::setw(8) << "frames"
+		<< std::setw(14) << "ms/frame" << std::setw(16) << "ns/boid/frame" << std::setw(10) << "exponent"
+		<< (options.usePerf ? "       IPC  cache-miss/boid" : "")
+#if BOIDS_PROFILING
+		<< "  visited/boid  kept%  VOs/boid"
+#endif
+		<< (reportDrift ? "  drift mean/max  heading deg" : "")
+		<< std::endl;
+
+	for (const ScalingSeries& series : makeSeries(options))
+	{
+		int previous = -1;
+		for (int boids : options.sizes)
+		{
+			ScalingResult result = runConfiguration(options, boids, series);
+			if (previous >= 0 && results[previous].boids > 0 && boids != results[previous].boids)
+				result.exponent = std::log(result.msPerFrame / results[previous].msPerFrame) /
+					std::log((double)boids / results[previous].boids);
+
+			std::cout << std::left << std::setw(76) << result.key << std::right << std::setw(8) << result.frames
+				<< std::fixed << std::setprecision(3) << std::setw(14) << result.msPerFrame
+				<< std::setprecision(1) << std::setw(16) << result.nsPerBoidFrame
+				<< std::setprecision(2) << std::setw(10) << result.exponent;
+			if (options.usePerf)
+			{
+				const PerfCounters::Sample& c = result.counters;
+				if (c.valid[(int)PerfCounter::cycles] && c.valid[(int)PerfCounter::instructions] && c.values[(int)PerfCounter::cycles] > 0.0)
+					std::cout << std::setw(10) << c.values[(int)PerfCounter::instructions] / c.values[(int)PerfCounter::cycles];
+				else
+					std::cout << std::setw(10) << "n/a";
+				if (c.valid[(int)PerfCounter::cacheMisses])
+					std::cout << std::setw(17) << c.values[(int)PerfCounter::cacheMisses] / ((double)result.frames * std::max(1, result.boids));
+				else
+					std::cout << std::setw(17) << "n/a";
+			}
+#if BOIDS_PROFILING
+			//Actor candidates from the data collection pass, the bulk of the neighbour search
+			float visited = result.getWorkCount(ProfileCounter::actorCandidates);
+			float accepted = result.getWorkCount(ProfileCounter::actorsAccepted);
+			std::cout << std::setprecision(1) << std::setw(14) << visited / std::max(1, result.boids)
+				<< std::setw(7) << (visited > 0.0f ? 100.0f * accepted / visited : 0.0f)
+				<< std::setprecision(2) << std::setw(10) << getVOsPerBoid(result);
+#endif
+			if (result.compact)
+				std::cout << std::setprecision(4) << std::setw(9) << result.meanDrift << "/" << std::left
+					<< std::setw(8) << result.maxDrift << std::right << std::setprecision(2)
+					<< std::setw(12) << result.meanHeadingDrift;
+			std::cout << std::endl;
+
+			results.push_back(result);
+			//Indexed as later push_backs can reallocate
+			previous = (int)results.size() - 1;
+		}
+	}
+
+	printBestIndices(results);
+
+	if (!options.jsonPath.empty() && !writeJson(options.jsonPath, options, results))
+		std::cout << "Failed to write " << options.jsonPath << std::endl;
+
+	if (options.baselinePath.empty())
+		return 0;
+
+	std::map<std::string, double> baseline;
+	if (!readBaseline(options.baselinePath, baseline))
+	{
+		std::cout << "Failed to read baseline " << options.baselinePath << std::endl;
+		return 1;
+	}
+
+	int regressions = 0;
+	std::cout << std::endl << "Against baseline " << options.baselinePath
+		<< " (threshold " << options.threshold * 100.0 << "%)" << std::endl;
+	for (const ScalingResult& result : results)
+	{
+		auto found = baseline.find(result.key);
+		if (found == baseline.end() || found->second <= 0.0)
+		{
+			std::cout << std::left << std::setw(76) << result.key << "  no baseline" << std::endl;
+			continue;
+		}
+		double change = result.msPerFrame / found->second - 1.0;
+		bool regressed = change > options.threshold;
+		regressions += regressed ? 1 : 0;
+		std::cout << std::left << std::setw(76) << result.key << std::right << std::fixed
+			<< std::setprecision(3) << std::setw(12) << found->second << " -> " << std::setw(12) << result.msPerFrame
+			<< std::setprecision(1) << std::setw(9) << std::showpos << change * 100.0 << "%" << std::noshowpos
+			<< (regressed ? "  REGRESSION" : "") << std::endl;
+	}
+	std::cout << regressions << " regression(s)" << std::endl;
+	return regressions > 0 ? 2 : 0;
+}
@@ -0,0 +1,42 @@
+#pragma once
+
+#include "Scenario.h"
+#include "SpatialIndex.h"
+#include <string>
+#include <vector>
+#include <utility>
+#include <cstdint>
+
+struct ScalingOptions
+{
+	std::vector<int> sizes = { 1000, 10000, 100000, 1000000 };
+	std::vector<int> threads = { 1 };
+	std::vector<bool> clearPath = { false, true };
+	//Quantised boid state. Compact runs also step a full float copy of the 
+	//world to report how far the quantised one drifted from it
+	std::vector<bool> compact = { false };
+	//Counting sort the partition every frame instead of keeping it linked
+	std::vector<bool> sortedPartition = { false };
+	//Every index is run on the same flocks, and the fastest for each is 
+	//reported at the end
+	std::vector<SpatialIndexType> indices = { SpatialIndexType::grid };
+	//Tight clusters crowd a few grid cells, which the trees cope with better
+	std::vector<SpawnPattern> patterns = { SpawnPattern::uniformBox };
+	//Pairs of detection and avoidance distance
+	std::vector<std::pair<float, float>> radii = { { 11.0f, 20.0f } };
+	int warmupFrames = 2;
+	int maxFrames = 100;
+	//Frames stop early once a configuration has run for this long
+	double maxSeconds = 2.0;
+	uint32_t seed = 12345;
+	std::string jsonPath;
+	std::string baselinePath;
+	//Fractional slowdown against the baseline that counts as a regression
+	double threshold = 0.10;
+	//Read Linux hardware counters around each configuration's frames
+	bool usePerf = false;
+};
+
+//Runs full steering + locomotion frames for every combination of the 
+//options. Returns non-zero if any configuration regressed against the baseline
+int runScalingBenchmarks(const ScalingOptions& options);
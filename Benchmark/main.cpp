@@ -0,0 +1,228 @@
+#include "BenchmarkUtils.h"
+#include "MicroBenchmarks.h"
+#include "ScalingBenchmarks.h"
+#include "CircleBenchmark.h"
+#include "ChurnBenchmark.h"
+
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <cstdlib>
+#include <thread>
+
+static const char* s_usage =
+	"Usage: Benchmark [--suite micro|scaling|circle|churn] [--json PATH]\n"
+	"  micro:   [--filter TEXT] [--min-time SECONDS]\n"
+	"  scaling: [--sizes N,N,...] [--threads N,N,...|all] [--rvo off|on|both]\n"
+	"           [--compact off|on|both] [--partition linked|sorted|both]\n"
+	"           [--index grid|kdtree|bvh|all] [--patterns uniform|clusters|ring|clump,...]\n"
+	"           [--radii DETECT:AVOID,...] [--frames N] [--max-seconds S] [--seed S]\n"
+	"           [--baseline PATH] [--threshold FRACTION] [--perf on|off]\n"
+	"  circle:  [--boids N,N,...] [--obstacles N,N,...] [--rvo off|on|both]\n"
+	"           [--obstacle-radius R] [--arrival DIST] [--frames N] [--seed S]\n"
+	"  churn:   [--populations N,N,...] [--rates N,N,...] [--emitters N]\n"
+	"           [--frames N] [--seed S]";
+
+static std::vector<std::string> splitList(const std::string& text)
+{
+	std::vector<std::string> items;
+	std::stringstream stream(text);
+	std::string item;
+	while (std::getline(stream, item, ','))
+	{
+		if (!item.empty())
+			items.push_back(item);
+	}
+	return items;
+}
+
+static std::vector<int> parseIntList(const std::string& text)
+{
+	std::vector<int> values;
+	for (const std::string& item : splitList(text))
+		values.push_back(std::atoi(item.c_str()));
+	return values;
+}
+
+int main(int argc, char* argv[])
+{
+	std::string suite = "micro";
+	std::string filter;
+	std::string jsonPath;
+	double minSeconds = 0.2;
+	ScalingOptions scaling;
+	CircleOptions circle;
+	ChurnOptions churn;
+
+	for (int i = 1; i < argc; i++)
+	{
+		//Every option takes a value
+		std::string arg = argv[i];
+		if (i + 1 >= argc)
+		{
+			std::cout << "Missing value for " << arg << std::endl << s_usage << std::endl;
+			return 1;
+		}
+		std::string value = argv[++i];
+
+		if (arg == "--suite")
+			suite = value;
+		else if (arg == "--filter")
+			filter = value;
+		else if (arg == "--min-time")
+			minSeconds = std::atof(value.c_str());
+		else if (arg == "--json")
+			jsonPath = value;
+		else if (arg == "--sizes")
+			scaling.sizes = parseIntList(value);
+		else if (arg == "--boids")
+			circle.boidCounts = parseIntList(value);
+		else if (arg == "--obstacles")
+			circle.obstacleCounts = parseIntList(value);
+		else if (arg == "--obstacle-radius")
+			circle.obstacleRadius = (float)std::atof(value.c_str());
+		else if (arg == "--arrival")
+			circle.arrivalDist = (float)std::atof(value.c_str());
+		else if (arg == "--populations")
+			churn.populations = parseIntList(value);
+		else if (arg == "--rates")
+			churn.rates = parseIntList(value);
+		else if (arg == "--emitters")
+			churn.emitters = std::max(1, std::atoi(value.c_str()));
+		else if (arg == "--threads")
+		{
+			scaling.threads.clear();
+			if (value == "all")
+			{
+				for (int threads = 1; threads < (int)std::thread::hardware_concurrency(); threads *= 2)
+					scaling.threads.push_back(threads);
+				scaling.threads.push_back(std::max(1, (int)std::thread::hardware_concurrency()));
+			}
+			else
+			{
+				for (const std::string& item : splitList(value))
+					scaling.threads.push_back(std::atoi(item.c_str()));
+			}
+		}
+		else if (arg == "--rvo")
+		{
+			scaling.clearPath.clear();
+			if (value != "on")
+				scaling.clearPath.push_back(false);
+			if (value != "off")
+				scaling.clearPath.push_back(true);
+			circle.clearPath = scaling.clearPath;
+		}
+		else if (arg == "--compact")
+		{
+			scaling.compact.clear();
+			if (value != "on")
+				scaling.compact.push_back(false);
+			if (value != "off")
+				scaling.compact.push_back(true);
+		}
+		else if (arg == "--partition")
+		{
+			scaling.sortedPartition.clear();
+			if (value != "sorted")
+				scaling.sortedPartition.push_back(false);
+			if (value != "linked")
+				scaling.sortedPartition.push_back(true);
+		}
+		else if (arg == "--index")
+		{
+			scaling.indices.clear();
+			SpatialIndexType index;
+			if (value == "all")
+				scaling.indices = { SpatialIndexType::grid, SpatialIndexType::kdTree, SpatialIndexType::bvh };
+			else if (parseSpatialIndexName(value.c_str(), index))
+				scaling.indices.push_back(index);
+			else
+			{
+				std::cout << "Unknown index: " << value << std::endl << s_usage << std::endl;
+				return 1;
+			}
+		}
+		else if (arg == "--patterns")
+		{
+			scaling.patterns.clear();
+			for (const std::string& item : splitList(value))
+			{
+				SpawnPattern pattern;
+				if (!parsePatternName(item.c_str(), pattern))
+				{
+					std::cout << "Unknown pattern: " << item << std::endl << s_usage << std::endl;
+					return 1;
+				}
+				scaling.patterns.push_back(pattern);
+			}
+		}
+		else if (arg == "--radii")
+		{
+			scaling.radii.clear();
+			for (const std::string& item : splitList(value))
+			{
+				size_t split = item.find(':');
+				float detect = (float)std::atof(item.c_str());
+				float avoid = split == std::string::npos ? detect : (float)std::atof(item.c_str() + split + 1);
+				scaling.radii.push_back({ detect, avoid });
+			}
+		}
+		else if (arg == "--frames")
+		{
+			scaling.maxFrames = std::atoi(value.c_str());
+			circle.maxFrames = scaling.maxFrames;
+			churn.maxFrames = scaling.maxFrames;
+		}
+		else if (arg == "--max-seconds")
+			scaling.maxSeconds = std::atof(value.c_str());
+		else if (arg == "--seed")
+		{
+			scaling.seed = (uint32_t)std::strtoul(value.c_str(), NULL, 10);
+			circle.seed = scaling.seed;
+			churn.seed = scaling.seed;
+		}
+		else if (arg == "--baseline")
+			scaling.baselinePath = value;
+		else if (arg == "--threshold")
+			scaling.threshold = std::atof(value.c_str());
+		else if (arg == "--perf")
+			scaling.usePerf = value == "on";
+		else
+		{
+			std::cout << "Unknown argument: " << arg << std::endl << s_usage << std::endl;
+			return 1;
+		}
+	}
+
+	if (suite == "scaling")
+	{
+		scaling.jsonPath = jsonPath;
+		return runScalingBenchmarks(scaling);
+	}
+	else if (suite == "circle")
+	{
+		circle.jsonPath = jsonPath;
+		return runCircleBenchmarks(circle);
+	}
+	else if (suite == "churn")
+	{
+		churn.jsonPath = jsonPath;
+		return runChurnBenchmarks(churn);
+	}
+	else if (suite != "micro")
+	{
+		std::cout << "Unknown suite: " << suite << std::endl << s_usage << std::endl;
+		return 1;
+	}
+
+	BenchmarkRunner runner(filter, minSeconds);
+	runMicroBenchmarks(runner);
+
+	if (!jsonPath.empty() && !runner.writeJson(jsonPath))
+	{
+		std::cout << "Failed to write " << jsonPath << std::endl;
+		return 1;
+	}
+	return 0;
+}
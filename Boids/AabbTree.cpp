@@ -0,0 +1,263 @@
+#include "AabbTree.h"
+#include <algorithm>
+
+template<int D>
+int BasicAabbTree<D>::allocateNode()
+{
+	int node;
+	if (m_freeList != nullNode)
+	{
+		node = m_freeList;
+		m_freeList = m_nodes[node].parent;
+	}
+	else
+	{
+		node = (int)m_nodes.size();
+		m_nodes.emplace_back();
+	}
+	m_nodes[node] = Node{ vec(), vec(), nullNode, nullNode, nullNode, 0, -1 };
+	return node;
+}
+
+template<int D>
+void BasicAabbTree<D>::freeNode(int node)
+{
+	m_nodes[node].parent = m_freeList;
+	m_nodes[node].height = -1;
+	m_freeList = node;
+}
+
+template<int D>
+float BasicAabbTree<D>::getCost(vec lo, vec hi)
+{
+	vec extent = hi - lo;
+	if constexpr (D == 2)
+		return extent.x + extent.y;
+	else
+		return extent.x * extent.y + extent.y * extent.z + extent.z * extent.x;
+}
+
+template<int D>
+void BasicAabbTree<D>::setLeafBox(int leaf, vec position)
+{
+	vec fat = Dimension<D>::splat(margin);
+	m_nodes[leaf].lo = position - fat;
+	m_nodes[leaf].hi = position + fat;
+}
+
+template<int D>
+void BasicAabbTree<D>::insertLeaf(int leaf)
+{
+	if (m_root == nullNode)
+	{
+		m_root = leaf;
+		m_nodes[leaf].parent = nullNode;
+		return;
+	}
+
+	//Walk down towards the sibling that grows the tree least, stopping
+	//early if pairing with the current node is cheaper than descending
+	vec leafLo = m_nodes[leaf].lo;
+	vec leafHi = m_nodes[leaf].hi;
+	int index = m_root;
+	while (!m_nodes[index].isLeaf())
+	{
+		const Node& node = m_nodes[index];
+		float cost = getCost(node.lo, node.hi);
+		float combinedCost = getCost(node.lo.min(leafLo), node.hi.max(leafHi));
+		//Pairing here adds a parent covering both
+		float pairCost = 2.0f * combinedCost;
+		//Descending grows this node's box whichever way the leaf goes
+		float inheritedCost = 2.0f * (combinedCost - cost);
+
+		auto getChildCost = [&](int child)
+		{
+			const Node& childNode = m_nodes[child];
+			float grown = getCost(childNode.lo.min(leafLo), childNode.hi.max(leafHi));
+			if (childNode.isLeaf())
+				return grown + inheritedCost;
+			return grown - getCost(childNode.lo, childNode.hi) + inheritedCost;
+		};
+		float leftCost = getChildCost(node.left);
+		float rightCost = getChildCost(node.right);
+
+		if (pairCost < leftCost && pairCost < rightCost)
+			break;
+		index = leftCost < rightCost ? node.left : node.right;
+	}
+
+	int sibling = index;
+	int oldParent = m_nodes[sibling].parent;
+	int newParent = allocateNode();
+	Node& parent = m_nodes[newParent];
+	parent.parent = oldParent;
+	parent.lo = m_nodes[sibling].lo.min(leafLo);
+	parent.hi = m_nodes[sibling].hi.max(leafHi);
+	parent.height = m_nodes[sibling].height + 1;
+	parent.left = sibling;
+	parent.right = leaf;
+	m_nodes[sibling].parent = newParent;
+	m_nodes[leaf].parent = newParent;
+
+	if (oldParent == nullNode)
+		m_root = newParent;
+	else if (m_nodes[oldParent].left == sibling)
+		m_nodes[oldParent].left = newParent;
+	else
+		m_nodes[oldParent].right = newParent;
+
+	refitUpwards(oldParent);
+}
+
+template<int D>
+void BasicAabbTree<D>::removeLeaf(int leaf)
+{
+	if (leaf == m_root)
+	{
+		m_root = nullNode;
+		return;
+	}
+
+	//The leaf's parent goes too, its other child taking its place
+	int parent = m_nodes[leaf].parent;
+	int grandParent = m_nodes[parent].parent;
+	int sibling = m_nodes[parent].left == leaf ? m_nodes[parent].right : m_nodes[parent].left;
+	freeNode(parent);
+	m_nodes[sibling].parent = grandParent;
+	if (grandParent == nullNode)
+	{
+		m_root = sibling;
+		return;
+	}
+
+	if (m_nodes[grandParent].left == parent)
+		m_nodes[grandParent].left = sibling;
+	else
+		m_nodes[grandParent].right = sibling;
+	refitUpwards(grandParent);
+}
+
+template<int D>
+void BasicAabbTree<D>::refitUpwards(int index)
+{
+	while (index != nullNode)
+	{
+		index = balance(index);
+		Node& node = m_nodes[index];
+		const Node& left = m_nodes[node.left];
+		const Node& right = m_nodes[node.right];
+		node.height = 1 + std::max(left.height, right.height);
+		node.lo = left.lo.min(right.lo);
+		node.hi = left.hi.max(right.hi);
+		index = node.parent;
+	}
+}
+
+template<int D>
+int BasicAabbTree<D>::balance(int iA)
+{
+	Node& A = m_nodes[iA];
+	if (A.isLeaf() || A.height < 2)
+		return iA;
+
+	int iB = A.left;
+	int iC = A.right;
+	Node& B = m_nodes[iB];
+	Node& C = m_nodes[iC];
+	int heightDiff = C.height - B.height;
+	if (heightDiff >= -1 && heightDiff <= 1)
+		return iA;
+
+	//Lifts the taller child X into A's place. A keeps its other child and
+	//takes whichever of X's children is shorter, X keeps the taller one
+	auto rotateUp = [&](int iX, Node& X, int& aSlot)
+	{
+		int iF = X.left;
+		int iG = X.right;
+		Node& F = m_nodes[iF];
+		Node& G = m_nodes[iG];
+
+		X.left = iA;
+		X.parent = A.parent;
+		A.parent = iX;
+		if (X.parent == nullNode)
+			m_root = iX;
+		else if (m_nodes[X.parent].left == iA)
+			m_nodes[X.parent].left = iX;
+		else
+			m_nodes[X.parent].right = iX;
+
+		int iKeep = F.height > G.height ? iF : iG;
+		int iGive = F.height > G.height ? iG : iF;
+		X.right = iKeep;
+		aSlot = iGive;
+		m_nodes[iGive].parent = iA;
+
+		const Node& other = m_nodes[A.left == iGive ? A.right : A.left];
+		const Node& give = m_nodes[iGive];
+		const Node& keep = m_nodes[iKeep];
+		A.lo = other.lo.min(give.lo);
+		A.hi = other.hi.max(give.hi);
+		A.height = 1 + std::max(other.height, give.height);
+		X.lo = A.lo.min(keep.lo);
+		X.hi = A.hi.max(keep.hi);
+		X.height = 1 + std::max(A.height, keep.height);
+		return iX;
+	};
+
+	if (heightDiff > 1)
+		return rotateUp(iC, C, A.right);
+	return rotateUp(iB, B, A.left);
+}
+
+template<int D>
+void BasicAabbTree<D>::build(const std::vector<vec>& positions)
+{
+	m_nodes.clear();
+	m_leafOf.clear();
+	m_root = nullNode;
+	m_freeList = nullNode;
+	//Leaves plus their parents
+	m_nodes.reserve(2 * positions.size());
+	update(positions);
+}
+
+template<int D>
+void BasicAabbTree<D>::update(const std::vector<vec>& positions)
+{
+	int count = (int)positions.size();
+	//Actors past the end have been removed. Those that took their place in
+	//the store are caught below as having jumped out of their leaves
+	while ((int)m_leafOf.size() > count)
+	{
+		int leaf = m_leafOf.back();
+		removeLeaf(leaf);
+		freeNode(leaf);
+		m_leafOf.pop_back();
+	}
+	m_points.assign(positions.begin(), positions.end());
+
+	for (int i = 0; i < count; i++)
+	{
+		vec position = positions[i];
+		if (i < (int)m_leafOf.size())
+		{
+			int leaf = m_leafOf[i];
+			if (boxContains(m_nodes[leaf].lo, m_nodes[leaf].hi, position))
+				continue;
+			removeLeaf(leaf);
+			setLeafBox(leaf, position);
+			insertLeaf(leaf);
+			continue;
+		}
+
+		int leaf = allocateNode();
+		m_nodes[leaf].actor = i;
+		setLeafBox(leaf, position);
+		insertLeaf(leaf);
+		m_leafOf.push_back(leaf);
+	}
+}
+
+template class BasicAabbTree<2>;
+template class BasicAabbTree<3>;
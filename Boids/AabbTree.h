@@ -0,0 +1,119 @@
+#pragma once
+
+#include "Dimension.h"
+#include <vector>
+
+//Dynamic bounding volume hierarchy over actor positions. Each actor has a
+//leaf whose box reaches a margin past it, and is only refiled once it
+//leaves that box, so a flock moving steadily costs a few reinsertions a
+//frame rather than a rebuild. Leaves are placed where they grow the tree's
+//boxes least and kept balanced by rotations, so dense clusters get deep
+//narrow subtrees instead of crowded cells. Follows the spatial index
+//interface in SpatialIndex.h
+template<int D>
+class BasicAabbTree
+{
+public:
+	using vec = VecN<D>;
+	//How far a leaf's box reaches past its actor. Wider boxes are refiled 
+	//less often but overlap more, which slows every query
+	static constexpr float margin = 1.0f;
+private:
+	static const int nullNode = -1;
+	//Leaves have no children and hold an actor. Free nodes are chained
+	//through parent
+	struct Node
+	{
+		vec lo, hi;
+		int parent;
+		int left, right;
+		//0 for leaves
+		int height;
+		int actor;
+
+		bool isLeaf() const { return left == nullNode; }
+	};
+	//Balancing keeps the height under 1.44 log2 of the leaf count
+	static const int maxStack = 96;
+
+	std::vector<Node> m_nodes;
+	int m_root = nullNode;
+	int m_freeList = nullNode;
+	//Leaf holding each actor
+	std::vector<int> m_leafOf;
+	//Where each actor was at the last update, which queries test against
+	std::vector<vec> m_points;
+
+	int allocateNode();
+	void freeNode(int node);
+	//Perimeter in 2D and surface area in 3D, which is what the chance of a
+	//query hitting a box scales with
+	static float getCost(vec lo, vec hi);
+	void insertLeaf(int leaf);
+	void removeLeaf(int leaf);
+	//Rotates a node's children if their heights differ by more than one.
+	//Returns the node now in its place
+	int balance(int node);
+	//Rebalances and refits every node from this one to the root
+	void refitUpwards(int node);
+	void setLeafBox(int leaf, vec position);
+
+	template<typename Overlaps, typename Contains, typename Visit>
+	void query(Overlaps overlaps, Contains contains, Visit visit) const;
+public:
+	void build(const std::vector<vec>& positions);
+	void update(const std::vector<vec>& positions);
+
+	template<typename Visit>
+	void queryRadius(vec centre, float radius, Visit visit) const;
+	template<typename Visit>
+	void queryBox(vec lo, vec hi, Visit visit) const;
+
+	int getHeight() const { return m_root == nullNode ? 0 : m_nodes[m_root].height; }
+};
+
+template<int D>
+template<typename Overlaps, typename Contains, typename Visit>
+void BasicAabbTree<D>::query(Overlaps overlaps, Contains contains, Visit visit) const
+{
+	if (m_root == nullNode)
+		return;
+
+	int stack[maxStack];
+	int top = 0;
+	stack[top++] = m_root;
+	while (top > 0)
+	{
+		const Node& node = m_nodes[stack[--top]];
+		if (!overlaps(node))
+			continue;
+		if (node.isLeaf())
+		{
+			if (contains(m_points[node.actor]))
+				visit(node.actor);
+			continue;
+		}
+		stack[top++] = node.right;
+		stack[top++] = node.left;
+	}
+}
+
+template<int D>
+template<typename Visit>
+void BasicAabbTree<D>::queryRadius(vec centre, float radius, Visit visit) const
+{
+	float radiusSq = radius * radius;
+	query([&](const Node& node) { return boxDistSq(node.lo, node.hi, centre) <= radiusSq; },
+		[&](vec point) { return (point - centre).square() <= radiusSq; }, visit);
+}
+
+template<int D>
+template<typename Visit>
+void BasicAabbTree<D>::queryBox(vec lo, vec hi, Visit visit) const
+{
+	query([&](const Node& node) { return boxesOverlap(node.lo, node.hi, lo, hi); },
+		[&](vec point) { return boxContains(lo, hi, point); }, visit);
+}
+
+using AabbTree = BasicAabbTree<2>;
+using AabbTree3D = BasicAabbTree<3>;
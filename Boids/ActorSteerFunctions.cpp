@@ -1,10 +1,13 @@
 #include "ActorSteerFunctions.h"
-#include "vec3.h"
-#include "Boid.h"
+#include "BoidStore.h"
 #include "Obstacle.h"
-#include "SpacePartition.h"
+#include "ObstacleIndex.h"
+#include "SpatialIndex.h"
+#include "KdTree.h"
+#include "AabbTree.h"
+#include "CompactBoidStore.h"
+#include "Profiler.h"
 #include <vector>
-#include <list>
 #include <algorithm>
 #define _USE_MATH_DEFINES
 #include <math.h>
@@ -12,122 +15,160 @@
 using namespace ASF;
 
 //Adds a vector to another, capping the length of the second such that the result's length is 1 or less
-void ASF::accumulate(vec3& acc, vec3 add)
+template<typename Vec>
+void ASF::accumulate(Vec& acc, Vec add)
 {
 	if (acc.mag() == 1.0f)
 		return;
 
 	float dot = acc.dot(add);
-	float root = std::sqrtf((dot * dot) - (add.square() * (acc.square() - 1)));
+	float root = std::sqrt((dot * dot) - (add.square() * (acc.square() - 1)));
 	float A = (-dot + root) / (acc.square() - 1);
 	float B = (-dot - root) / (acc.square() - 1);
 
 	if (A >= 0.0f)
 	{
-		A = std::fminf(1.0f, A);
+		A = std::fmin(1.0f, A);
 		acc = acc + (add * A);
 		acc = acc.unit();
 		return;
 	}
 	else if (B >= 0.0f)
 	{
-		B = std::fminf(1.0f, B);
+		B = std::fmin(1.0f, B);
 		acc = acc + (add * B);
 		acc = acc.unit();
 		return;
 	}
 }
 
-void ASF::flattenVectortoPlane(vec3& vector, vec3 plane)
+template<typename Vec>
+void ASF::flattenVectortoPlane(Vec& vector, Vec plane)
 {
-	plane = plane.unit();
-	vector -= plane * plane.dot(vector);
+	vector = vector.reject(plane.unit());
 }
 
-//Helper for actorDataCollection. Collects actor data from a list
-void collectFromActors(vec3& sumPosition, vec3& sumVelocity, vec3& collision,
-	int& count, float& closestDist, const Boid& self, const std::list<const Boid*>& boidList)
+//Candidates looked at and kept by one of the collection helpers, summed 
+//locally and handed to the thread's counter batch once per boid
+struct QueryCounts
 {
-	for (const Boid* boid : boidList)
+	int visited = 0;
+	int accepted = 0;
+};
+
+//Reads neighbours for collectFromActors straight from the store's arrays
+template<int D>
+struct StoreReader
+{
+	const BasicBoidStore<D>& boids;
+
+	VecN<D> getPosition(int boid) const { return boids.position[boid]; }
+	VecN<D> getVelocity(int boid) const { return boids.velocity[boid]; }
+};
+
+//Helper for actorDataCollection. Collects actor data from the neighbours 
+//query passes to its visitor, reading them through either a StoreReader or 
+//a CompactBoidStore
+template<int D, typename Query, typename Reader>
+static void collectFromActors(VecN<D>& sumPosition, VecN<D>& sumVelocity, VecN<D>& collision,
+	int& count, float& closestDist, const BasicBoidStore<D>& boids, int self, Query query,
+	const Reader& reader, QueryCounts& counts)
+{
+	using vec = VecN<D>;
+	const BoidProfile& profile = boids.getProfile(self);
+	vec selfPosition = boids.position[self];
+	vec selfVelocity = boids.velocity[self];
+	float selfSpeed = selfVelocity.mag();
+
+	query([&](int boid)
 	{
-		if (!boid)
-			continue;
+		counts.visited++;
+		vec boidPosition = reader.getPosition(boid);
 		//rather than creating the flock store the average of nearby velocities and positions simultaneously as it saves on temp data
-		vec3 diff = boid->getPosition() - self.getPosition();
+		vec diff = boidPosition - selfPosition;
 
 		//Don't count self
-		if (diff == vec3())
-			continue;
+		if (diff == vec())
+			return;
+
+		//Out of range of both the neighbour and collision checks
+		float distSq = diff.square();
+		if (distSq >= profile.detectionDistSq && distSq > profile.avoidanceDistSq)
+			return;
 
 		//Blind behind
-		float sigma = diff.dot(self.getVelocity()) / (diff.mag() * self.getVelocity().mag());
-		if (acos(sigma) > M_PI * self.getViewArc())
-			continue;
+		float dist = std::sqrt(distSq);
+		float sigma = diff.dot(selfVelocity) / (dist * selfSpeed);
+		if (sigma < profile.cosViewArc)
+			return;
+		counts.accepted++;
 
+		vec boidVelocity = reader.getVelocity(boid);
 		//Neighbour data
-		if (diff.mag() < self.getDetectionDist())
+		if (distSq < profile.detectionDistSq)
 		{
-			sumPosition += boid->getPosition();
-			sumVelocity += boid->getVelocity() - self.getVelocity();
+			sumPosition += boidPosition;
+			sumVelocity += boidVelocity - selfVelocity;
 			count++;
 		}
 
 		//Collision checking
-		//Find position of closest intercept in near future (midpoint between the two closest points bounded between 0 and nearFuture)
-		float nearFuture = self.getAvoidanceDist() / self.getMaxSpeed();
-		float steps = self.getAvoidanceDist() / self.getRadius(); //Should be based on the radius of the object
-
 		//Determine if it's close enough to care
-		if (self.getAvoidanceDist() < diff.mag())
-			continue;
+		if (distSq > profile.avoidanceDistSq)
+			return;
 
+		//Find position of closest intercept in near future (midpoint between the two closest points bounded between 0 and nearFuture)
 		//Check iteratively for collisions
-		for (float t = 0.0f; t <= nearFuture; t += (nearFuture / steps))
+		float combinedRadius = profile.radius + boids.getProfile(boid).radius;
+		for (float t = 0.0f; t <= profile.nearFuture; t += profile.timeStep)
 		{
-			vec3 selfPosition = self.getPosition() + (self.getVelocity() * t);
-			vec3 otherPosition = boid->getPosition() + (boid->getVelocity() * t);
-			float potentialClosest = (otherPosition - self.getPosition()).mag();
+			vec selfFuture = selfPosition.mulAdd(selfVelocity, t);
+			vec otherPosition = boidPosition.mulAdd(boidVelocity, t);
+			float potentialClosest = (otherPosition - selfPosition).mag();
 
 			//Move on if this will not provide a closer collision than has already been detected
 			if (potentialClosest > closestDist)
 				continue;
 
-			if ((otherPosition - selfPosition).mag() <= self.getRadius() + boid->getRadius())
+			if ((otherPosition - selfFuture).mag() <= combinedRadius)
 			{
 				closestDist = potentialClosest;
 				//This treats the potential moving collision target as a static object at the intercept
-				collision = otherPosition - self.getPosition();
+				collision = otherPosition - selfPosition;
 			}
 		}
-	}
+	});
 }
 
-//Helper for actorDataCollection. Collects obstacle data from a list
-void collectFromObstacles(vec3& collision, vec3 facingDirection, vec3 position,
-	float avoidanceDist, float radius, const std::list<const Obstacle*>& obstList)
+//Helper for actorDataCollection. Collects obstacle data from those the 
+//obstacle index finds around the actor
+template<int D>
+static void collectFromObstacles(VecN<D>& collision, VecN<D> facingDirection, VecN<D> position,
+	float avoidanceDist, float radius, float queryRadius, const BasicObstacleIndex<D>& obstacles,
+	QueryCounts& counts)
 {
 	//Create temp storage of closest obstacle
 	float closestDist = avoidanceDist;
-	if (collision != vec3())
+	if (collision != VecN<D>())
 		closestDist = collision.mag();
 
-	for (const Obstacle* obstacle : obstList)
+	obstacles.query(position, queryRadius, [&](const auto& obstacle)
 	{
-		if (!obstacle)
-			continue;
-
-		vec3 diff = obstacle->m_position - position;
+		counts.visited++;
+		VecN<D> diff = obstacle.position - position;
 
 		//Scale by facing direction
 		float distForward = facingDirection.dot(diff);
 
-		//Cull results outside box ends
-		if (distForward <= 0 || distForward > avoidanceDist)
-			continue;
+		//Cull results outside box ends. Large obstacles count as soon as 
+		//their near side is in range
+		if (distForward <= 0 || distForward - obstacle.radius > avoidanceDist)
+			return;
 
 		//Cull results too far from the sides
-		if ((diff - (facingDirection * distForward)).mag() > radius + obstacle->m_radius)
-			continue;
+		if ((diff - (facingDirection * distForward)).mag() > radius + obstacle.radius)
+			return;
+		counts.accepted++;
 
 		//If closest obstacle set as such and store relative position
 		if (closestDist > diff.mag())
@@ -135,136 +176,142 @@ void collectFromObstacles(vec3& collision, vec3 facingDirection, vec3 position,
 			closestDist = diff.mag();
 			collision = diff;
 		}
-	}
+	});
 }
 
-void ASF::actorDataCollection(vec3& sumPosition, vec3& sumVelocity, vec3& collision,
-	const Boid& self, const SpacePartition& partition)
+template<int D, typename Index>
+void ASF::actorDataCollection(VecN<D>& sumPosition, VecN<D>& sumVelocity, VecN<D>& collision,
+	const BasicBoidStore<D>& boids, int self, const BasicObstacleIndex<D>& obstacles,
+	const Index& index, const CompactBoidStore* compact)
 {
+	using vec = VecN<D>;
+	const BoidProfile& profile = boids.getProfile(self);
+	vec position = boids.position[self];
+	float avoid = profile.avoidanceDist;
+	float radius = profile.radius;
 	//Create temp storage of closest collision
-	float closestDist = self.getAvoidanceDist();
-	if (collision != vec3())
+	float closestDist = avoid;
+	if (collision != vec())
 		closestDist = collision.square();
 	int sumCount = 0;
-	vec3 facing = self.getVelocity().unit();
-	//Find the search region
-	CellRange range = partition.findCellRange(self.getPosition(), std::max(self.getDetectionDist(), self.getAvoidanceDist()));
+	QueryCounts actorCounts, obstacleCounts;
+	vec facing = boids.velocity[self].unit();
 
-	//Check through each cell in range
-	for (int y = range.blY; y < range.trY; y++)
+	auto collect = [&](const auto& reader)
 	{
-		for (int x = range.blX; x < range.trX; x++)
-		{
-			collectFromActors(sumPosition, sumVelocity, collision,
-				sumCount, closestDist, self, partition.getCell(x, y).actors);
-			collectFromObstacles(collision, facing, self.getPosition(),
-				self.getAvoidanceDist(), self.getRadius(), partition.getCell(x, y).obstacles);
-		}
-	}
-	if (range.incOOB)
+		auto query = [&](auto visit) { index.queryRadius(position, profile.queryRadius, visit); };
+		collectFromActors<D>(sumPosition, sumVelocity, collision,
+			sumCount, closestDist, boids, self, query, reader, actorCounts);
+	};
+	//Chosen once per boid so each neighbour loop is compiled for one layout
+	if constexpr (D == 2)
 	{
-		collectFromActors(sumPosition, sumVelocity, collision,
-			sumCount, closestDist, self, partition.getOOB().actors);
-		collectFromObstacles(collision, facing, self.getPosition(),
-			self.getAvoidanceDist(), self.getRadius(), partition.getOOB().obstacles);
+		if (compact)
+			collect(*compact);
+		else
+			collect(StoreReader<D>{ boids });
 	}
+	else
+		collect(StoreReader<D>{ boids });
+	collectFromObstacles<D>(collision, facing, position, avoid, radius, 
+		profile.queryRadius, obstacles, obstacleCounts);
+	PROFILE_COUNT(ProfileCounter::actorCandidates, actorCounts.visited);
+	PROFILE_COUNT(ProfileCounter::actorsAccepted, actorCounts.accepted);
+	PROFILE_COUNT(ProfileCounter::obstacleCandidates, obstacleCounts.visited);
+	PROFILE_COUNT(ProfileCounter::obstaclesAccepted, obstacleCounts.accepted);
 	sumPosition / sumCount;
 	sumVelocity / sumCount;
 }
 
-void getActorVOs(vec3 position, vec3 velocity, float avoidDist, float radius,
-	std::list<Shape>& velObsts, const std::list<const Boid*>& boidList)
+template<typename Query>
+static void getActorVOs(vec2 position, vec2 velocity, float avoidDist, float radius,
+	ShapeList& velObsts, const BoidStore& boids, Query query, QueryCounts& counts)
 {
-	for (const Boid* boid : boidList)
+	query([&](int boid)
 	{
-		if (!boid)
-			continue;
-
-		vec3 diff = boid->getPosition() - position;
+		counts.visited++;
+		vec2 diff = boids.position[boid] - position;
 
-		if (diff == vec3() || diff.mag() > avoidDist)
-			continue;
+		if (diff == vec2() || diff.mag() > avoidDist)
+			return;
 
-		vec3 velPos = (velocity + boid->getVelocity()) / 2;
+		vec2 velPos = (velocity + boids.velocity[boid]) / 2;
 
-		Shape tempVO = Shape(velPos);
+		Shape& tempVO = velObsts.emplace_back(velPos);
 		//Create a cone of vectors that intersect the boid
-		tempVO.addConeSection(diff, radius, boid->getRadius(), avoidDist * 10.0f);
+		tempVO.addConeSection(diff, radius, boids.getProfile(boid).radius, avoidDist * 10.0f);
 		//Add the rough shape of self to this viathe Minkowsky sum
 		tempVO.addSquare(velocity.unit(), radius);
 
-		velObsts.push_back(tempVO);
-	}
+		counts.accepted++;
+	});
 }
 
-void getObstacleVOs(vec3 position, vec3 velocity, float avoidDist, float radius,
-	std::list<Shape>& velObsts, const std::list<const Obstacle*>& obstList)
+static void getObstacleVOs(vec2 position, vec2 velocity, float avoidDist, float radius,
+	ShapeList& velObsts, const ObstacleIndex& obstacles, QueryCounts& counts)
 {
-	for (const Obstacle* obst : obstList)
+	obstacles.query(position, avoidDist, [&](const auto& obst)
 	{
-		if (!obst)
-			continue;
-
-		vec3 diff = obst->m_position - position;
+		counts.visited++;
+		vec2 diff = obst.position - position;
 
-		if (diff == vec3() || diff.mag() > avoidDist)
-			continue;
+		//Measured to the obstacle's surface so large ones aren't missed
+		if (diff == vec2() || diff.mag() - obst.radius > avoidDist)
+			return;
 
-		vec3 velPos = velocity / 2;
+		vec2 velPos = velocity / 2;
 
-		Shape tempVO = Shape(velPos);
+		Shape& tempVO = velObsts.emplace_back(velPos);
 		//Create a cone of vectors that intersect the obstacle
-		tempVO.addConeSection(diff, radius, obst->m_radius, avoidDist * 100.0f);
+		tempVO.addConeSection(diff, radius, obst.radius, avoidDist * 100.0f);
 		//Add the rough shape of self to this viathe Minkowsky sum
 		tempVO.addSquare(velocity.unit(), radius);
 
-		velObsts.push_back(tempVO);
-	}
+		counts.accepted++;
+	});
 }
 
-void ASF::velocityObstacleCollection(const Boid& self, std::list<Shape>& velocityObstacles,
-	const SpacePartition& partition)
+template<typename Index>
+void ASF::velocityObstacleCollection(const BoidStore& boids, int self, 
+	const ObstacleIndex& obstacles, ShapeList& velocityObstacles, const Index& index)
 {
 	//Create a list of shapes and gather common data
-	vec3 pos = self.getPosition();
-	vec3 vel = self.getVelocity();
-	float avoid = self.getAvoidanceDist();
-	float radius = self.getRadius();
+	const BoidProfile& profile = boids.getProfile(self);
+	vec2 pos = boids.position[self];
+	vec2 vel = boids.velocity[self];
+	float avoid = profile.avoidanceDist;
+	float radius = profile.radius;
+	QueryCounts actorCounts, obstacleCounts;
 
 	//For all nearby boids and obstacles create a VO and translate by (v1 + v2) / 2
-	CellRange range = partition.findCellRange(self.getPosition(), self.getAvoidanceDist());
-	for (int y = range.blY; y < range.trY; y++)
-	{
-		for (int x = range.blX; x < range.trX; x++)
-		{
-			getActorVOs(pos, vel, avoid, radius, velocityObstacles, partition.getCell(x, y).actors);
-			getObstacleVOs(pos, vel, avoid, radius, velocityObstacles, partition.getCell(x, y).obstacles);
-		}
-	}
-	if (range.incOOB)
-	{
-		getActorVOs(pos, vel, avoid, radius, velocityObstacles, partition.getOOB().actors);
-		getObstacleVOs(pos, vel, avoid, radius, velocityObstacles, partition.getOOB().obstacles);
-	}
+	auto query = [&](auto visit) { index.queryRadius(pos, avoid, visit); };
+	getActorVOs(pos, vel, avoid, radius, velocityObstacles, boids, query, actorCounts);
+	getObstacleVOs(pos, vel, avoid, radius, velocityObstacles, obstacles, obstacleCounts);
+	PROFILE_COUNT(ProfileCounter::actorVOCandidates, actorCounts.visited);
+	PROFILE_COUNT(ProfileCounter::actorVOsBuilt, actorCounts.accepted);
+	PROFILE_COUNT(ProfileCounter::obstacleVOCandidates, obstacleCounts.visited);
+	PROFILE_COUNT(ProfileCounter::obstacleVOsBuilt, obstacleCounts.accepted);
+	PROFILE_COUNT(ProfileCounter::voCollections, 1);
 }
 
-vec3 ASF::simpleCollisionAvoidance(vec3 collision, vec3 facingDirection)
+template<typename Vec>
+Vec ASF::simpleCollisionAvoidance(Vec collision, Vec facingDirection)
 {
-	if (collision != vec3())
+	if (collision != Vec())
 	{
-		vec3 avoidDirection = vec3() - (collision - facingDirection * collision.dot(facingDirection));
+		Vec avoidDirection = -collision.reject(facingDirection);
 		return avoidDirection.unit();
 	}
-	return vec3();
+	return Vec();
 }
 
-vec3 ASF::clearPathSampling(vec3 targetAcceleration, vec3 currentVel, float maxVel, 
-	std::list<Shape>& velocityObstacles)
+vec2 ASF::clearPathSampling(vec2 targetAcceleration, vec2 currentVel, float maxVel, 
+	ShapeList& velocityObstacles)
 {
-	vec3 samples[6];
+	vec2 samples[6];
 	//Construct set of potential velocities to sample
 	{
-		vec3 targetVel = currentVel + targetAcceleration;
+		vec2 targetVel = currentVel + targetAcceleration;
 		float targetAngle = atan2(targetVel.y, targetVel.x);
 		float facingAngle = atan2(currentVel.y, currentVel.x);
 		float angle1 = facingAngle + M_PI / 4;
@@ -273,10 +320,10 @@ vec3 ASF::clearPathSampling(vec3 targetAcceleration, vec3 currentVel, float maxV
 		float angle4 = facingAngle - M_PI / 2;
 		samples[0] = targetVel.unit() * maxVel;
 		samples[1] = targetVel.unit() * maxVel;
-		samples[2] = vec3(cos(angle1), sin(angle1), 0.0f) * maxVel;
-		samples[3] = vec3(cos(angle2), sin(angle2), 0.0f) * maxVel;
-		samples[4] = vec3(cos(angle3), sin(angle3), 0.0f) * maxVel;
-		samples[5] = vec3(cos(angle4), sin(angle4), 0.0f) * maxVel;
+		samples[2] = vec2(cos(angle1), sin(angle1)) * maxVel;
+		samples[3] = vec2(cos(angle2), sin(angle2)) * maxVel;
+		samples[4] = vec2(cos(angle3), sin(angle3)) * maxVel;
+		samples[5] = vec2(cos(angle4), sin(angle4)) * maxVel;
 	}
 	//Gradually reduce vector length until a solution is found
 	for (float scale = 1.0f; scale > 0.0f; scale -= 0.1f)
@@ -298,46 +345,80 @@ vec3 ASF::clearPathSampling(vec3 targetAcceleration, vec3 currentVel, float maxV
 		{
 			if (sampleSuccess[i])
 			{
-				vec3 velocitySuggestion = samples[i] * scale;
+				vec2 velocitySuggestion = samples[i] * scale;
 				return (velocitySuggestion - currentVel).unit();
 			}
 		}
 	}
-	return vec3();
+	return vec2();
 }
 
-vec3 ASF::seekTowards(vec3 position, vec3 homeLocation, float homeDist, vec3 facingDirection)
+template<typename Vec>
+Vec ASF::seekTowards(Vec position, Vec homeLocation, float homeDist, Vec facingDirection)
 {
-	vec3 homeVec = homeLocation - position;
-	if (homeVec.mag() > homeDist)
+	Vec homeVec = homeLocation - position;
+	if (homeVec.square() > homeDist * homeDist)
 	{
-		vec3 avoidDirection = homeVec - facingDirection.unit() * homeVec.dot(facingDirection.unit());
+		Vec avoidDirection = homeVec.reject(facingDirection.unit());
 		return avoidDirection.unit();
 	}
-	return vec3();
+	return Vec();
 }
 
-vec3 ASF::matchFlockVelocity(vec3 sumVelocity, float maxAcceleration, vec3 facingDirection)
+template<typename Vec>
+Vec ASF::matchFlockVelocity(Vec sumVelocity, float maxAcceleration, Vec facingDirection)
 {
-	if (sumVelocity != vec3())
+	if (sumVelocity != Vec())
 	{
-		vec3 matchVel = sumVelocity / maxAcceleration;
-		matchVel = matchVel - facingDirection.unit() * matchVel.dot(facingDirection.unit());
-		if (matchVel.mag() > 1.0f)
+		Vec matchVel = sumVelocity / maxAcceleration;
+		matchVel = matchVel.reject(facingDirection.unit());
+		if (matchVel.square() > 1.0f)
 			matchVel = matchVel.unit();
 		return matchVel;
 	}
-	return vec3();
+	return Vec();
 }
 
-vec3 ASF::matchFlockCentre(vec3 sumPosition, vec3 facingDirection)
+template<typename Vec>
+Vec ASF::matchFlockCentre(Vec sumPosition, Vec facingDirection)
 {
-	if (sumPosition != vec3())
+	if (sumPosition != Vec())
 	{
-		vec3 matchPos = sumPosition - facingDirection.unit() * sumPosition.dot(facingDirection.unit());
-		if (matchPos.mag() > 1.0f)
+		Vec matchPos = sumPosition.reject(facingDirection.unit());
+		if (matchPos.square() > 1.0f)
 			matchPos = matchPos.unit();
 		return matchPos;
 	}
-	return vec3();
-}
\ No newline at end of file
+	return Vec();
+}
+
+template void ASF::accumulate(vec2&, vec2);
+template void ASF::accumulate(vec3&, vec3);
+template void ASF::flattenVectortoPlane(vec2&, vec2);
+template void ASF::flattenVectortoPlane(vec3&, vec3);
+template void ASF::actorDataCollection<2>(vec2&, vec2&, vec2&, const BoidStore&, int, 
+	const ObstacleIndex&, const GridIndex<2>&, const CompactBoidStore*);
+template void ASF::actorDataCollection<2>(vec2&, vec2&, vec2&, const BoidStore&, int, 
+	const ObstacleIndex&, const KdTree&, const CompactBoidStore*);
+template void ASF::actorDataCollection<2>(vec2&, vec2&, vec2&, const BoidStore&, int, 
+	const ObstacleIndex&, const AabbTree&, const CompactBoidStore*);
+template void ASF::actorDataCollection<3>(vec3&, vec3&, vec3&, const BoidStore3D&, int, 
+	const ObstacleIndex3D&, const GridIndex<3>&, const CompactBoidStore*);
+template void ASF::actorDataCollection<3>(vec3&, vec3&, vec3&, const BoidStore3D&, int, 
+	const ObstacleIndex3D&, const KdTree3D&, const CompactBoidStore*);
+template void ASF::actorDataCollection<3>(vec3&, vec3&, vec3&, const BoidStore3D&, int, 
+	const ObstacleIndex3D&, const AabbTree3D&, const CompactBoidStore*);
+template void ASF::velocityObstacleCollection(const BoidStore&, int, const ObstacleIndex&, 
+	ShapeList&, const GridIndex<2>&);
+template void ASF::velocityObstacleCollection(const BoidStore&, int, const ObstacleIndex&, 
+	ShapeList&, const KdTree&);
+template void ASF::velocityObstacleCollection(const BoidStore&, int, const ObstacleIndex&, 
+	ShapeList&, const AabbTree&);
+template vec2 ASF::simpleCollisionAvoidance(vec2, vec2);
+template vec3 ASF::simpleCollisionAvoidance(vec3, vec3);
+template vec2 ASF::seekTowards(vec2, vec2, float, vec2);
+template vec3 ASF::seekTowards(vec3, vec3, float, vec3);
+template vec2 ASF::matchFlockVelocity(vec2, float, vec2);
+template vec3 ASF::matchFlockVelocity(vec3, float, vec3);
+template vec2 ASF::matchFlockCentre(vec2, vec2);
+template vec3 ASF::matchFlockCentre(vec3, vec3);
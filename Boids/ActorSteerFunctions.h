@@ -1,51 +1,68 @@
 #pragma once
 
+#include "Dimension.h"
 #include "Shape.h"
+#include "FrameArena.h"
 #include <vector>
-#include <list>
 
-class vec3;
-class SpacePartition;
-class Boid;
-class Obstacle;
+class CompactBoidStore;
 
-//Actor Steer Functions
+//Actor Steer Functions. Those working on plain vectors or on a boid store 
+//are instantiated for vec2 and vec3. Velocity obstacles are built from 
+//planar shapes so clear path avoidance is 2D only
 namespace ASF
 {
+	//Velocity obstacles gathered for one boid, allocated from the steering 
+	//arena. Shapes hold their edges inline so sampling walks one array
+	using ShapeList = std::vector<Shape, ArenaAllocator<Shape>>;
+
 	//Utility
 
 	//Adds a vector to another, capping the length of the second such that 
 	//the result's length is 1 or less
-	void accumulate(vec3& acc, vec3 add);
+	template<typename Vec>
+	void accumulate(Vec& acc, Vec add);
 	//Collapses a vector to a plane
-	void flattenVectortoPlane(vec3& vector, vec3 plane);
+	template<typename Vec>
+	void flattenVectortoPlane(Vec& vector, Vec plane);
 
 	//Data collection
 
-	//Collects actor and obstacle data from the area surrounding an actor
-	void actorDataCollection(vec3& sumPosition, vec3& sumVelocity, vec3& collision,
-		const Boid& self, const SpacePartition& partition);
+	//Collects actor and obstacle data from the area surrounding an actor. 
+	//Actors are found through the spatial index, any of those in 
+	//SpatialIndex.h, and obstacles through the obstacle index. Neighbours 
+	//are read from the compact store if one is given, which only the 2D 
+	//build does
+	template<int D, typename Index>
+	void actorDataCollection(VecN<D>& sumPosition, VecN<D>& sumVelocity, VecN<D>& collision,
+		const BasicBoidStore<D>& boids, int self, const BasicObstacleIndex<D>& obstacles,
+		const Index& index, const CompactBoidStore* compact = nullptr);
 	//Collects regions of undesirable velocity for use by the clearPathSampling
-	void velocityObstacleCollection(const Boid& self, std::list<Shape>& velocityObstacles,
-		const SpacePartition& partition);
+	template<typename Index>
+	void velocityObstacleCollection(const BoidStore& boids, int self, 
+		const ObstacleIndex& obstacles, ShapeList& velocityObstacles, const Index& index);
 
 	//Final steering activities
 
 	//Avoid potential future collisions by deviating from the path of the 
 	//nearest collision. Returns an acceleration
-	vec3 simpleCollisionAvoidance(vec3 closestCollision, vec3 facingDirection);
+	template<typename Vec>
+	Vec simpleCollisionAvoidance(Vec closestCollision, Vec facingDirection);
 	//Avoid collisions via sampling possible velocities against other entities
 	//RVOs and picking the best result. Should be calculated after other
 	//acceleration sources, but take precedence when taking the final sum. 
 	//Returns an acceleration
-	vec3 clearPathSampling(vec3 targetAcceleration, vec3 currentVel, float maxVel,
-		std::list<Shape>& velocityObstacles);
+	vec2 clearPathSampling(vec2 targetAcceleration, vec2 currentVel, float maxVel,
+		ShapeList& velocityObstacles);
 	//Attempt to move within a given distance from the destination by the 
 	//shortest route possible. Returns an acceleration
-	vec3 seekTowards(vec3 position, vec3 homeLocation, float homeDist, vec3 facingDirection);
+	template<typename Vec>
+	Vec seekTowards(Vec position, Vec homeLocation, float homeDist, Vec facingDirection);
 	//Get the vector average velocity of the flock. Returns an acceleration
-	vec3 matchFlockVelocity(vec3 sumVelocity, float maxAcceleration, vec3 facingDirection);
+	template<typename Vec>
+	Vec matchFlockVelocity(Vec sumVelocity, float maxAcceleration, Vec facingDirection);
 	//Get the vector to the centre of the nearby flock. Returns an acceleration
-	vec3 matchFlockCentre(vec3 sumPosition, vec3 facingDirection);
+	template<typename Vec>
+	Vec matchFlockCentre(Vec sumPosition, Vec facingDirection);
 };
 
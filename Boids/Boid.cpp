@@ -1,132 +1,146 @@
 #include "Boid.h"
-#include "Shader.h"
-#include "VertexArray.h"
 #include "SpacePartition.h"
-#include "glm/gtc/matrix_transform.hpp"
+#include "ObstacleIndex.h"
+#include "SpatialIndex.h"
+#include "KdTree.h"
+#include "AabbTree.h"
 #include "ActorSteerFunctions.h"
-
-Boid::Boid(vec3 pos, vec3 vel, SpacePartition& partition, VertexArray& vao, IndexBuffer& ia, Texture& tex, Texture& outlineTexR, Texture& outlineTexB, Shader& shader)
-	: m_position(pos), m_velocity(vel), m_acceleration(vec3()), m_homeLocation(vec3()), m_maxAcceleration(1.0f), m_maxSpeed(10.0f), m_homeDist(100.0f),
-	m_viewArc(0.75f), m_radius(2.0f), m_avoidanceDistance(5.0f), m_detectionDistance(10.0f), m_partition(partition), m_vao(vao),
-	m_ib(ia), m_tex(tex), m_outlineR(outlineTexR), m_outlineB(outlineTexB), m_shader(shader)
-{
-	m_partition.addActor(this);
-}
-
-Boid::~Boid()
-{
-	m_partition.removeActor(this);
-}
-
-void Boid::steering()
-{
-	vec3 oldAcceleration = m_acceleration;
-	m_acceleration = vec3();
-	vec3 facingDir = m_velocity.unit();
-	//Find actor steering data
-	vec3 sumPos = vec3();
-	vec3 sumVel = vec3();
-	vec3 sumCol = vec3();
-	std::list<Shape> velObst;
-
-	ASF::actorDataCollection(sumPos, sumVel, sumCol, *this, m_partition);
-
-	if (m_useClearPath)
-		ASF::velocityObstacleCollection(*this, velObst, m_partition);
-
-	//Accumulating forces
-	if (!m_useClearPath)
-		ASF::accumulate(m_acceleration,
-			ASF::simpleCollisionAvoidance(sumCol, facingDir));
-
-	if (m_useFlockBehaviour)
-		ASF::accumulate(m_acceleration,
-			ASF::matchFlockVelocity(sumVel, m_maxAcceleration, facingDir) * 0.8f);
-
-	if (m_useFlockBehaviour)
-		ASF::accumulate(m_acceleration,
-			ASF::matchFlockCentre(sumPos, facingDir) * 0.8f);
-
-	ASF::accumulate(m_acceleration,
-		ASF::seekTowards(m_position, m_homeLocation, m_homeDist, facingDir));
-
-	//Ensure acceleration is perpendicular to velocity
-	m_acceleration = m_acceleration - facingDir.unit() * m_acceleration.dot(facingDir.unit());
-
-	//RVO
-	if (m_useClearPath)
-		m_acceleration = 
-			ASF::clearPathSampling(m_acceleration, m_velocity, m_maxSpeed, velObst);
-
-	//Damping
-	m_acceleration = (m_acceleration + oldAcceleration) / 2;
-}
-
-void Boid::locomotion(float deltaT)
-{
-	m_velocity += m_acceleration * m_maxAcceleration * deltaT;
-	m_velocity = m_velocity.unit() * m_maxSpeed;
-
-	vec3 oldPosition = m_position;
-	m_position += m_velocity * deltaT;
-
-	m_partition.haveMoved(this, oldPosition);
-}
-
-void Boid::draw(Renderer & renderer, glm::mat4 viewProjection)
+#include "Profiler.h"
+#include <algorithm>
+
+//Boids are steered a chunk at a time, each phase running over the whole 
+//chunk before the next starts, so the profiler times a phase once per 
+//chunk rather than once per boid
+static const int steeringChunk = 64;
+
+template<int D, typename Index>
+void Boid::steering(BasicBoidStore<D>& boids, int begin, int end, 
+	const BasicObstacleIndex<D>& obstacles, const Index& index, FrameArena& arena, 
+	const CompactBoidStore* compact)
 {
-	m_shader.bind();
-	m_tex.bind(0);
-
-	//Get the rotation pivot
-	glm::vec3 worldUp = glm::vec3(0.0f, 1.0f, 0.0f);
-	glm::vec3 vel;
-	if (m_velocity != vec3())
-		vel = glm::normalize(glm::vec3(m_velocity.x, m_velocity.y, m_velocity.z));
-	else
-		vel = glm::vec3(1.0f);
-
-	glm::vec3 pivot = glm::normalize(glm::cross(worldUp, vel));
-
-	//Get rotation amount
-	float angle = glm::acos(glm::dot(vel, worldUp));
-
-	glm::mat4 scale = glm::scale(glm::mat4(1.0f), glm::vec3(m_radius/2));
-	glm::mat4 rotate = glm::rotate(glm::mat4(1.0f), angle, pivot);
-	glm::mat4 translate = glm::translate(
-		glm::mat4(1.0f), glm::vec3(m_position.x, m_position.y, m_position.z));
-
-	glm::mat4 model = translate * rotate * scale;
-	glm::mat4 modelViewProjection = viewProjection * model;
-
-	m_shader.setUniform1i("u_texture", 0);
-	m_shader.setUniformMat4f("u_modelViewProjection", modelViewProjection);
-
-	renderer.draw(m_vao, m_ib, m_shader);
+	using vec = VecN<D>;
+	using VecList = std::vector<vec, ArenaAllocator<vec>>;
+	//Velocity obstacles are planar, so in 3D everything below to do with 
+	//them compiles away
+	constexpr bool canClearPath = D == 2;
+	//Each worker calls this once per frame with its own range
+	PROFILE_COUNT_BATCH();
+	PROFILE_TOTAL(collectionTime, ProfilePhase::dataCollection);
+	PROFILE_TOTAL(voTime, ProfilePhase::voConstruction);
+	PROFILE_TOTAL(samplingTime, ProfilePhase::clearPathSampling);
+
+	for (int chunk = begin; chunk < end; chunk += steeringChunk)
+	{
+		int chunkEnd = std::min(chunk + steeringChunk, end);
+		int count = chunkEnd - chunk;
+		FrameArena::Scope scratch(arena);
+		//Trace events carry the first boid's position, which the Morton 
+		//reorder keeps close to the rest of the chunk. Unused when the timers 
+		//are compiled out
+		[[maybe_unused]] vec first = boids.position[chunk];
+
+		//Find actor steering data
+		VecList sumPos(count, vec(), ArenaAllocator<vec>(arena));
+		VecList sumVel(count, vec(), ArenaAllocator<vec>(arena));
+		VecList sumCol(count, vec(), ArenaAllocator<vec>(arena));
+		{
+			PROFILE_SCOPE_INTO_AT(collectionTime, first.x, first.y);
+			for (int i = 0; i < count; i++)
+				ASF::actorDataCollection<D>(sumPos[i], sumVel[i], sumCol[i], boids, chunk + i, 
+					obstacles, index, compact);
+		}
+
+		std::vector<ASF::ShapeList, ArenaAllocator<ASF::ShapeList>> velObsts{ ArenaAllocator<ASF::ShapeList>(arena) };
+		if constexpr (canClearPath)
+		{
+			velObsts.reserve(count);
+			for (int i = 0; i < count; i++)
+				velObsts.emplace_back(ArenaAllocator<Shape>(arena));
+			PROFILE_SCOPE_INTO_AT(voTime, first.x, first.y);
+			for (int i = 0; i < count; i++)
+			{
+				if (boids.getProfile(chunk + i).useClearPath)
+					ASF::velocityObstacleCollection(boids, chunk + i, obstacles, velObsts[i], index);
+			}
+		}
+
+		//Accumulating forces
+		VecList accelerations(count, vec(), ArenaAllocator<vec>(arena));
+		for (int i = 0; i < count; i++)
+		{
+			int self = chunk + i;
+			const BoidProfile& profile = boids.getProfile(self);
+			vec position = boids.position[self];
+			vec facingDir = boids.velocity[self].unit();
+			bool useClearPath = canClearPath && profile.useClearPath;
+			vec& acceleration = accelerations[i];
+
+			if (!useClearPath)
+				ASF::accumulate(acceleration,
+					ASF::simpleCollisionAvoidance(sumCol[i], facingDir));
+
+			if (profile.useFlocking)
+				ASF::accumulate(acceleration,
+					ASF::matchFlockVelocity(sumVel[i], profile.maxAcceleration, facingDir) * 0.8f);
+
+			if (profile.useFlocking)
+				ASF::accumulate(acceleration,
+					ASF::matchFlockCentre(sumPos[i], facingDir) * 0.8f);
+
+			ASF::accumulate(acceleration,
+				ASF::seekTowards(position, boids.homeLocation[self], profile.homeDist, facingDir));
+
+			//Ensure acceleration is perpendicular to velocity
+			acceleration = acceleration.reject(facingDir);
+		}
+
+		//RVO
+		if constexpr (canClearPath)
+		{
+			PROFILE_SCOPE_INTO_AT(samplingTime, first.x, first.y);
+			for (int i = 0; i < count; i++)
+			{
+				const BoidProfile& profile = boids.getProfile(chunk + i);
+				if (profile.useClearPath)
+					accelerations[i] = ASF::clearPathSampling(accelerations[i], 
+						boids.velocity[chunk + i], profile.maxSpeed, velObsts[i]);
+			}
+		}
+
+		//Damping
+		for (int i = 0; i < count; i++)
+			boids.acceleration[chunk + i] = (accelerations[i] + boids.acceleration[chunk + i]) / 2;
+	}
 }
 
-void Boid::drawAuras(
-	Renderer& renderer, glm::mat4 viewProjection, bool drawAvoid, bool drawDetect)
+template<int D>
+void Boid::locomotion(BasicBoidStore<D>& boids, float deltaT, BasicSpacePartition<D>& partition)
 {
-	m_shader.bind();
-	if (drawAvoid)
+	PROFILE_COUNT_BATCH();
+	int count = boids.size();
+	for (int i = 0; i < count; i++)
 	{
-		m_outlineR.bind(0);
-		glm::mat4 scale = glm::scale(glm::mat4(1.0f), glm::vec3(m_avoidanceDistance/2));
-		glm::mat4 model = glm::translate(glm::mat4(1.0f), glm::vec3(m_position.x, m_position.y, m_position.z));
-		glm::mat4 modelViewProjection = viewProjection * model * scale;
-		m_shader.setUniform1i("u_texture", 0);
-		m_shader.setUniformMat4f("u_modelViewProjection", modelViewProjection);
-		renderer.draw(m_vao, m_ib, m_shader);
-	}
-	if (drawDetect)
-	{
-		m_outlineB.bind(0);
-		glm::mat4 scale = glm::scale(glm::mat4(1.0f), glm::vec3(m_detectionDistance/2));
-		glm::mat4 model = glm::translate(glm::mat4(1.0f), glm::vec3(m_position.x, m_position.y, m_position.z));
-		glm::mat4 modelViewProjection = viewProjection * model * scale;
-		m_shader.setUniform1i("u_texture", 0);
-		m_shader.setUniformMat4f("u_modelViewProjection", modelViewProjection);
-		renderer.draw(m_vao, m_ib, m_shader);
+		const BoidProfile& profile = boids.getProfile(i);
+		VecN<D> velocity = boids.velocity[i] + boids.acceleration[i] * profile.maxAcceleration * deltaT;
+		velocity = velocity.unit() * profile.maxSpeed;
+		boids.velocity[i] = velocity;
+
+		boids.position[i] = boids.position[i] + velocity * deltaT;
+		partition.haveMoved(i, boids.position[i]);
 	}
 }
+
+template void Boid::steering<2>(BoidStore&, int, int, const ObstacleIndex&, 
+	const GridIndex<2>&, FrameArena&, const CompactBoidStore*);
+template void Boid::steering<2>(BoidStore&, int, int, const ObstacleIndex&, 
+	const KdTree&, FrameArena&, const CompactBoidStore*);
+template void Boid::steering<2>(BoidStore&, int, int, const ObstacleIndex&, 
+	const AabbTree&, FrameArena&, const CompactBoidStore*);
+template void Boid::steering<3>(BoidStore3D&, int, int, const ObstacleIndex3D&, 
+	const GridIndex<3>&, FrameArena&, const CompactBoidStore*);
+template void Boid::steering<3>(BoidStore3D&, int, int, const ObstacleIndex3D&, 
+	const KdTree3D&, FrameArena&, const CompactBoidStore*);
+template void Boid::steering<3>(BoidStore3D&, int, int, const ObstacleIndex3D&, 
+	const AabbTree3D&, FrameArena&, const CompactBoidStore*);
+template void Boid::locomotion<2>(BoidStore&, float, SpacePartition&);
+template void Boid::locomotion<3>(BoidStore3D&, float, SpacePartition3D&);
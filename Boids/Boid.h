@@ -1,74 +1,26 @@
 #pragma once
-#include "vec3.h"
-#include "Renderer.h"
-#include "Texture.h"
-#include "glm/glm.hpp"
+#include "BoidStore.h"
+#include "Obstacle.h"
+#include "FrameArena.h"
 #include <vector>
 
-class SpacePartition;
+class CompactBoidStore;
 
-class Boid
+//Per frame update of the boids held in a store, instantiated for 2D and 3D
+namespace Boid
 {
-private:
-	vec3 m_position;
-	vec3 m_velocity;
-	vec3 m_acceleration;
-	vec3 m_homeLocation;
-
-	float m_maxAcceleration;
-	float m_maxSpeed;
-	float m_homeDist;
-	float m_viewArc;
-	float m_radius;
-	float m_avoidanceDistance;
-	float m_detectionDistance;
-
-	bool m_useFlockBehaviour = true;
-	bool m_useClearPath = false;
-
-	SpacePartition& m_partition;
-	VertexArray& m_vao;
-	IndexBuffer& m_ib;
-	Texture& m_tex;
-	Texture& m_outlineR;
-	Texture& m_outlineB;
-	Shader& m_shader;
-public:
-	Boid(vec3 pos, vec3 vel, SpacePartition& partition, VertexArray& vao, 
-		IndexBuffer& ia, Texture& tex, Texture& outlineTexR, Texture& outlineTexB, 
-		Shader& shader);
-	~Boid();
-
-	void steering();
-	void locomotion(float deltaT);
-	void draw(Renderer& renderer, glm::mat4 viewProjection);
-	void drawAuras(Renderer& renderer, glm::mat4 viewProjection,
-		bool drawAvoid, bool drawDetect);
-
-	vec3 getPosition() const { return m_position; }
-	vec3 getVelocity() const { return m_velocity; }
-	vec3 getAcceleration() const { return m_acceleration; }
-	vec3& refAcceleration() { return m_acceleration; }
-	float getMaxAcceleration() const { return m_maxAcceleration; }
-	float getMaxSpeed() const { return m_maxSpeed; }
-	float getHomeDistance() const { return m_homeDist; }
-	vec3 getHomeLocation() const { return m_homeLocation; }
-	float getViewArc() const { return m_viewArc; }
-	float getRadius() const { return m_radius;  }
-	float getAvoidanceDist() const { return m_avoidanceDistance; }
-	float getDetectionDist() const { return m_detectionDistance; }
-	bool getClearUsage() const { return m_useClearPath; }
-
-	void setPosition(vec3 pos) { m_position = pos; }
-	void setVelocity(vec3 vel) { m_velocity = vel; }
-	void setFlocking(bool useFlocking) { m_useFlockBehaviour = useFlocking; }
-	void setClearUsage(bool useCP) { m_useClearPath = useCP; }
-	void setMaxAcceleration(float newMax) { m_maxAcceleration = newMax; }
-	void setSpeed(float newSpeed) { m_maxSpeed = newSpeed; }
-	void setHomeDist(float newDist) { m_homeDist = newDist; }
-	void setHomeLocation(vec3 newLocation) { m_homeLocation = newLocation; }
-	void setViewArc(float newArc) { m_viewArc = newArc; }
-	void setRadius(float newRadius) { m_radius = newRadius; }
-	void setAvoidanceDist(float newDist) { m_avoidanceDistance = newDist; }
-	void setDetectionDist(float newDist) { m_detectionDistance = newDist; }
+	//Calculates the acceleration of boids [begin, end). Only their own 
+	//accelerations are written, so separate ranges can be steered in parallel 
+	//as long as each has its own arena. Boids are steered in small chunks, 
+	//whose temporaries are released before the next. The 3D build always uses simple collision avoidance. 
+	//Neighbours are found through the spatial index and obstacles through 
+	//the obstacle index. If a compact store is given, neighbours are read 
+	//from it
+	template<int D, typename Index>
+	void steering(BasicBoidStore<D>& boids, int begin, int end, 
+		const BasicObstacleIndex<D>& obstacles, const Index& index, FrameArena& arena, 
+		const CompactBoidStore* compact = nullptr);
+	//Moves every boid along its velocity and refiles it in the partition
+	template<int D>
+	void locomotion(BasicBoidStore<D>& boids, float deltaT, BasicSpacePartition<D>& partition);
 };
@@ -0,0 +1,43 @@
+#pragma once
+
+#include <cmath>
+
+//Steering parameters shared by every boid that refers to the profile. 
+//Boids store a small index instead of their own copy, so changing a 
+//parameter is one write however large the flock
+struct BoidProfile
+{
+	float maxAcceleration = 1.0f;
+	float maxSpeed = 10.0f;
+	float homeDist = 100.0f;
+	float viewArc = 0.75f;
+	float radius = 2.0f;
+	float avoidanceDist = 5.0f;
+	float detectionDist = 10.0f;
+	bool useFlocking = true;
+	bool useClearPath = false;
+
+	//Derived from the parameters above by update() so the neighbour loops 
+	//don't recompute them for every candidate
+
+	//Neighbours with a smaller cosine to the heading are behind the view arc
+	float cosViewArc = 0.0f;
+	float detectionDistSq = 0.0f;
+	float avoidanceDistSq = 0.0f;
+	float queryRadius = 0.0f;
+	//How far ahead collisions are predicted and the step used to walk that time
+	float nearFuture = 0.0f;
+	float timeStep = 0.0f;
+
+	void update()
+	{
+		const float pi = 3.14159265358979f;
+		cosViewArc = std::cos(pi * viewArc);
+		detectionDistSq = detectionDist * detectionDist;
+		avoidanceDistSq = avoidanceDist * avoidanceDist;
+		queryRadius = std::fmax(detectionDist, avoidanceDist);
+		nearFuture = avoidanceDist / maxSpeed;
+		float steps = avoidanceDist / radius; //Should be based on the radius of the object
+		timeStep = nearFuture / steps;
+	}
+};
@@ -0,0 +1,103 @@
+#include "BoidStore.h"
+
+template<int D>
+BasicBoidStore<D>::BasicBoidStore()
+{
+	addProfile(BoidProfile());
+}
+
+template<int D>
+int BasicBoidStore<D>::add(vec pos, vec vel, int profileIndex)
+{
+	position.push_back(pos);
+	velocity.push_back(vel);
+	acceleration.push_back(vec());
+	homeLocation.push_back(vec());
+	profile.push_back((uint16_t)profileIndex);
+	handles.insert();
+	return size() - 1;
+}
+
+//Moves the last element of an array into a gap and drops the last slot
+template<typename T>
+static void swapRemove(std::vector<T>& values, int index)
+{
+	values[index] = values.back();
+	values.pop_back();
+}
+
+template<int D>
+int BasicBoidStore<D>::remove(int index)
+{
+	int last = size() - 1;
+	swapRemove(position, index);
+	swapRemove(velocity, index);
+	swapRemove(acceleration, index);
+	swapRemove(homeLocation, index);
+	swapRemove(profile, index);
+	handles.erase(index);
+	return index != last ? last : -1;
+}
+
+//Rebuilds an array with the element at order[i] in position i. The old 
+//array is left in scratch, ready for the next one of the same type
+template<typename T>
+static void gather(std::vector<T>& values, const std::vector<int>& order, std::vector<T>& scratch)
+{
+	scratch.resize(values.size());
+	for (size_t i = 0; i < order.size(); i++)
+		scratch[i] = values[order[i]];
+	values.swap(scratch);
+}
+
+template<int D>
+void BasicBoidStore<D>::permute(const std::vector<int>& order, PermuteScratch& scratch)
+{
+	gather(position, order, scratch.vectors);
+	gather(velocity, order, scratch.vectors);
+	gather(acceleration, order, scratch.vectors);
+	gather(homeLocation, order, scratch.vectors);
+	gather(profile, order, scratch.profiles);
+	handles.permute(order, scratch.slots);
+}
+
+template<int D>
+void BasicBoidStore<D>::reserve(int count)
+{
+	position.reserve(count);
+	velocity.reserve(count);
+	acceleration.reserve(count);
+	homeLocation.reserve(count);
+	profile.reserve(count);
+	handles.reserve(count);
+}
+
+template<int D>
+void BasicBoidStore<D>::clear()
+{
+	position.clear();
+	velocity.clear();
+	acceleration.clear();
+	homeLocation.clear();
+	profile.clear();
+	handles.clear();
+	profiles.resize(1);
+}
+
+template<int D>
+int BasicBoidStore<D>::addProfile(const BoidProfile& newProfile)
+{
+	profiles.push_back(newProfile);
+	profiles.back().update();
+	return (int)profiles.size() - 1;
+}
+
+template<int D>
+void BasicBoidStore<D>::setProfile(int index, const BoidProfile& newProfile)
+{
+	profiles[index] = newProfile;
+	profiles[index].update();
+}
+
+template struct BasicBoidStore<2>;
+template struct BasicBoidStore<3>;
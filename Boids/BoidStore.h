@@ -0,0 +1,60 @@
+#pragma once
+
+#include "Dimension.h"
+#include "SlotMap.h"
+#include "BoidProfile.h"
+#include <vector>
+#include <cstdint>
+
+//Every boid's state kept as one array per field, indexed by boid. Steering 
+//and locomotion walk these arrays directly, so a pass only pulls the fields 
+//it reads through the cache
+template<int D>
+struct BasicBoidStore
+{
+	using vec = VecN<D>;
+
+	std::vector<vec> position;
+	std::vector<vec> velocity;
+	std::vector<vec> acceleration;
+	//Destinations are per boid so that the circle test can send each boid 
+	//to a different point
+	std::vector<vec> homeLocation;
+	//Index into profiles
+	std::vector<uint16_t> profile;
+
+	//Shared parameter blocks. Change them through setProfile so the derived 
+	//values are refreshed. Profile 0 always exists and is used by default
+	std::vector<BoidProfile> profiles;
+
+	//Indices shift as boids are removed, handles stay with their boid
+	SlotMap handles;
+
+	BasicBoidStore();
+
+	int size() const { return (int)position.size(); }
+	const BoidProfile& getProfile(int boid) const { return profiles[profile[boid]]; }
+
+	//Appends a boid and returns its index
+	int add(vec pos, vec vel, int profileIndex = 0);
+	//Fills the gap with the last boid. Returns the index that boid had, or 
+	//-1 if the removed boid was the last one
+	int remove(int index);
+	//Spare arrays permute gathers into and then swaps with the store's own, 
+	//so an owner that keeps one reuses the same memory every reorder
+	struct PermuteScratch
+	{
+		std::vector<vec> vectors;
+		std::vector<uint16_t> profiles;
+		std::vector<uint32_t> slots;
+	};
+
+	//Moves the boid at order[i] to index i for every i. Handles follow their boids
+	void permute(const std::vector<int>& order, PermuteScratch& scratch);
+	void reserve(int count);
+	//Removes every boid and every profile but the first
+	void clear();
+
+	int addProfile(const BoidProfile& newProfile);
+	void setProfile(int index, const BoidProfile& newProfile);
+};
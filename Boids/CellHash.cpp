@@ -0,0 +1,68 @@
+#include "CellHash.h"
+
+static const int s_initialBits = 8;
+static const int s_coordBias = 1 << 20;
+
+CellHash::Key CellHash::makeKey(int x, int y, int z)
+{
+	//21 bits per axis, biased so they are never negative
+	return (Key)(clampCoord(x) + s_coordBias) | 
+		((Key)(clampCoord(y) + s_coordBias) << 21) | 
+		((Key)(clampCoord(z) + s_coordBias) << 42);
+}
+
+void CellHash::splitKey(Key key, int& x, int& y, int& z)
+{
+	const Key mask = (1 << 21) - 1;
+	x = (int)(key & mask) - s_coordBias;
+	y = (int)((key >> 21) & mask) - s_coordBias;
+	z = (int)((key >> 42) & mask) - s_coordBias;
+}
+
+int CellHash::insert(Key key)
+{
+	size_t mask = m_slots.size() - 1;
+	size_t slot = getSlot(key);
+	for (;; slot = (slot + 1) & mask)
+	{
+		const Slot& probe = m_slots[slot];
+		if (probe.key == key)
+			return probe.cell;
+		if (probe.key == emptyKey)
+			break;
+	}
+
+	int cell = (int)m_keys.size();
+	m_keys.push_back(key);
+	m_slots[slot] = { key, cell };
+	if (m_keys.size() * 2 > m_slots.size())
+		grow();
+	return cell;
+}
+
+void CellHash::grow()
+{
+	//Cell numbers never change, so every cell just goes back in
+	m_shift--;
+	m_slots.assign(m_slots.size() * 2, { emptyKey, -1 });
+	size_t mask = m_slots.size() - 1;
+	for (int cell = 0; cell < (int)m_keys.size(); cell++)
+	{
+		size_t slot = getSlot(m_keys[cell]);
+		while (m_slots[slot].key != emptyKey)
+			slot = (slot + 1) & mask;
+		m_slots[slot] = { m_keys[cell], cell };
+	}
+}
+
+void CellHash::clear()
+{
+	m_shift = 64 - s_initialBits;
+	m_slots.assign((size_t)1 << s_initialBits, { emptyKey, -1 });
+	m_keys.clear();
+}
+
+CellHash::CellHash()
+{
+	clear();
+}
@@ -0,0 +1,60 @@
+#pragma once
+
+#include <vector>
+#include <cstdint>
+#include <cstddef>
+
+//Open addressed hash table from integer cell coordinates to dense cell 
+//numbers, which are handed out in the order cells are first used. Probes 
+//linearly through a power of two table that is kept at most half full
+class CellHash
+{
+public:
+	using Key = uint64_t;
+	//Coordinates are clamped to this either side of zero
+	static const int coordLimit = (1 << 20) - 1;
+private:
+	struct Slot
+	{
+		Key key;
+		int cell;
+	};
+	static const Key emptyKey = ~(Key)0;
+
+	std::vector<Slot> m_slots;
+	//Coordinates of each cell by cell number
+	std::vector<Key> m_keys;
+	int m_shift;
+
+	size_t getSlot(Key key) const { return (size_t)((key * 0x9E3779B97F4A7C15ull) >> m_shift); }
+	void grow();
+public:
+	//Packs three coordinates, each clamped to coordLimit, into one key
+	static Key makeKey(int x, int y, int z);
+	static void splitKey(Key key, int& x, int& y, int& z);
+	static int clampCoord(int coord) { return coord < -coordLimit ? -coordLimit : (coord > coordLimit ? coordLimit : coord); }
+
+	//Cell number of a coordinate, or -1 if it has never been used. Inline 
+	//as every partition query calls it once per cell it covers
+	int find(Key key) const
+	{
+		size_t mask = m_slots.size() - 1;
+		for (size_t slot = getSlot(key);; slot = (slot + 1) & mask)
+		{
+			const Slot& probe = m_slots[slot];
+			if (probe.key == key)
+				return probe.cell;
+			if (probe.key == emptyKey)
+				return -1;
+		}
+	}
+	//Cell number of a coordinate, giving it the next one if it is new
+	int insert(Key key);
+	//Forgets every cell so numbering starts again from 0
+	void clear();
+
+	int size() const { return (int)m_keys.size(); }
+	Key getKey(int cell) const { return m_keys[cell]; }
+
+	CellHash();
+};
@@ -0,0 +1,103 @@
+#include "CellLinks.h"
+#include <algorithm>
+
+void CellLinks::unlink(int entity)
+{
+	CellList::Link& self = m_links[entity];
+	Ends& ends = m_cells[self.cell];
+	if (self.prev >= 0)
+		m_links[self.prev].next = self.next;
+	else
+		ends.head = self.next;
+	if (self.next >= 0)
+		m_links[self.next].prev = self.prev;
+	else
+		ends.tail = self.prev;
+	ends.count--;
+	self.cell = -1;
+}
+
+void CellLinks::link(int entity, int cell)
+{
+	CellList::Link& self = m_links[entity];
+	Ends& ends = m_cells[cell];
+	self.cell = cell;
+	self.next = -1;
+	self.prev = ends.tail;
+	if (ends.tail >= 0)
+		m_links[ends.tail].next = entity;
+	else
+		ends.head = entity;
+	ends.tail = entity;
+	ends.count++;
+}
+
+void CellLinks::setCellCount(int count)
+{
+	m_cells.resize(count);
+}
+
+void CellLinks::insert(int entity, int cell)
+{
+	if (entity >= (int)m_links.size())
+		m_links.resize(entity + 1, { -1, -1, -1 });
+	link(entity, cell);
+}
+
+void CellLinks::erase(int entity)
+{
+	unlink(entity);
+}
+
+void CellLinks::move(int entity, int cell)
+{
+	if (m_links[entity].cell == cell)
+		return;
+	unlink(entity);
+	link(entity, cell);
+}
+
+void CellLinks::rename(int oldIndex, int newIndex)
+{
+	if (newIndex >= (int)m_links.size())
+		m_links.resize(newIndex + 1, { -1, -1, -1 });
+	CellList::Link self = m_links[oldIndex];
+	Ends& ends = m_cells[self.cell];
+	if (self.prev >= 0)
+		m_links[self.prev].next = newIndex;
+	else
+		ends.head = newIndex;
+	if (self.next >= 0)
+		m_links[self.next].prev = newIndex;
+	else
+		ends.tail = newIndex;
+	m_links[newIndex] = self;
+	m_links[oldIndex].cell = -1;
+}
+
+void CellLinks::remap(const std::vector<int>& newIndex)
+{
+	auto renumber = [&](int entity) { return entity >= 0 ? newIndex[entity] : -1; };
+	//Entities past the end of the links were never filed
+	int count = (int)std::min(newIndex.size(), m_links.size());
+	m_remapped.assign(std::max(newIndex.size(), m_links.size()), { -1, -1, -1 });
+	for (int i = 0; i < count; i++)
+	{
+		const CellList::Link& old = m_links[i];
+		if (old.cell >= 0)
+			m_remapped[newIndex[i]] = { renumber(old.next), renumber(old.prev), old.cell };
+	}
+	for (Ends& ends : m_cells)
+	{
+		ends.head = renumber(ends.head);
+		ends.tail = renumber(ends.tail);
+	}
+	m_links.swap(m_remapped);
+}
+
+void CellLinks::clear()
+{
+	for (Ends& ends : m_cells)
+		ends = Ends();
+	m_links.clear();
+}
@@ -0,0 +1,87 @@
+#pragma once
+
+#include <vector>
+
+//Read only walk over the entities filed in one cell, in the order they
+//were filed. Views into CellLinks, so only valid until it next changes
+class CellList
+{
+public:
+	struct Link
+	{
+		int next;
+		int prev;
+		//-1 while the entity is not filed
+		int cell;
+	};
+
+	class iterator
+	{
+	private:
+		const Link* m_links;
+		int m_entity;
+	public:
+		iterator(const Link* links, int entity) : m_links(links), m_entity(entity) {}
+		int operator*() const { return m_entity; }
+		iterator& operator++() { m_entity = m_links[m_entity].next; return *this; }
+		bool operator==(const iterator& rhs) const { return m_entity == rhs.m_entity; }
+		bool operator!=(const iterator& rhs) const { return m_entity != rhs.m_entity; }
+	};
+private:
+	const Link* m_links;
+	int m_head;
+	int m_count;
+public:
+	CellList(const Link* links, int head, int count) : m_links(links), m_head(head), m_count(count) {}
+
+	iterator begin() const { return iterator(m_links, m_head); }
+	iterator end() const { return iterator(m_links, -1); }
+	int size() const { return m_count; }
+	bool empty() const { return m_count == 0; }
+};
+
+//Files entities of one kind into cells as intrusive doubly linked lists.
+//The links and the cell each entity is in are kept in an array indexed by
+//entity, so filing, moving and removing are O(1) and make no allocations
+//once the arrays have grown to the number of entities
+class CellLinks
+{
+private:
+	struct Ends
+	{
+		int head = -1;
+		int tail = -1;
+		int count = 0;
+	};
+
+	std::vector<Ends> m_cells;
+	std::vector<CellList::Link> m_links;
+	//Kept between remaps to avoid reallocating it
+	std::vector<CellList::Link> m_remapped;
+
+	void unlink(int entity);
+	void link(int entity, int cell);
+public:
+	//New cells start empty. Any cells dropped must be empty already
+	void setCellCount(int count);
+	int getCellCount() const { return (int)m_cells.size(); }
+
+	//Appends an entity that isn't filed yet to a cell
+	void insert(int entity, int cell);
+	void erase(int entity);
+	//Moves an entity to the back of another cell, doing nothing if it is
+	//already there
+	void move(int entity, int cell);
+	//Gives the entity filed as oldIndex the unused index newIndex, keeping
+	//its place in its cell
+	void rename(int oldIndex, int newIndex);
+	//Renumbers every entity, i becoming newIndex[i], keeping cell order
+	void remap(const std::vector<int>& newIndex);
+	//Unfiles everything, keeping the cells
+	void clear();
+
+	//-1 if not filed
+	int getCell(int entity) const { return entity < (int)m_links.size() ? m_links[entity].cell : -1; }
+	int getCount(int cell) const { return m_cells[cell].count; }
+	CellList getList(int cell) const { return CellList(m_links.data(), m_cells[cell].head, m_cells[cell].count); }
+};
@@ -0,0 +1,87 @@
+#include "CellWidthTuner.h"
+#include <algorithm>
+#include <cmath>
+
+template<int D>
+typename BasicCellWidthTuner<D>::Estimate BasicCellWidthTuner<D>::predict(float width) const
+{
+	Estimate estimate;
+	estimate.width = width;
+	int samples = (int)m_radii.size();
+	for (int s = 0; s < samples; s++)
+	{
+		//On average a query's box spans 2r / w + 1 cells along each axis
+		float span = 2.0f * m_radii[s] + width;
+		estimate.cells += std::pow(span / width, (float)D);
+		estimate.candidates += m_densities[s] * std::pow(span, (float)D);
+	}
+	if (samples > 0)
+	{
+		estimate.cells /= samples;
+		estimate.candidates /= samples;
+	}
+	estimate.cost = cellCost * estimate.cells + estimate.candidates;
+	return estimate;
+}
+
+template<int D>
+float BasicCellWidthTuner<D>::update(const BasicBoidStore<D>& boids, const BasicSpacePartition<D>& partition)
+{
+	float width = partition.getPartitionWidth();
+	if (m_framesUntilTune-- > 0)
+		return width;
+	m_framesUntilTune = m_interval - 1;
+
+	int count = boids.size();
+	if (count == 0)
+		return width;
+
+	//Spread evenly through the store, which the Morton reorder keeps
+	//roughly in spatial order, so the samples cover the whole flock
+	int samples = std::min(count, sampleCount);
+	int stride = count / samples;
+	m_nextSample = (m_nextSample + 1) % stride;
+	m_radii.clear();
+	m_densities.clear();
+	float cellVolume = std::pow(width, (float)D);
+	float radiusSum = 0.0f;
+	for (int s = 0; s < samples; s++)
+	{
+		int boid = m_nextSample + s * stride;
+		float radius = boids.getProfile(boid).queryRadius;
+		vec extent = Dimension<D>::splat(radius);
+		vec position = boids.position[boid];
+		//Built directly so the samples don't show in the partition's counters
+		CellRange<D> range = makeCellRange<D>(position - extent, position + extent, width);
+		int cells = 1;
+		for (int axis = 0; axis < D; axis++)
+			cells *= range.tr[axis] - range.bl[axis];
+		int candidates = 0;
+		partition.forEachCell(range, [&](const auto& cell) { candidates += cell.actors.size(); });
+
+		//Over the whole region the query read, not just its radius
+		m_radii.push_back(radius);
+		m_densities.push_back(candidates / (cells * cellVolume));
+		radiusSum += radius;
+	}
+
+	m_current = predict(width);
+	m_best = m_current;
+	float meanRadius = radiusSum / samples;
+	if (meanRadius <= 0.0f)
+		return width;
+	for (int step = 0; step < widthSteps; step++)
+	{
+		float candidate = std::max(meanRadius * std::exp2((step - 12) * 0.25f), minWidth);
+		Estimate estimate = predict(candidate);
+		if (estimate.cost < m_best.cost)
+			m_best = estimate;
+	}
+
+	if (m_best.cost < m_current.cost * (1.0f - minSaving))
+		return m_best.width;
+	return width;
+}
+
+template class BasicCellWidthTuner<2>;
+template class BasicCellWidthTuner<3>;
@@ -0,0 +1,75 @@
+#pragma once
+
+#include "Dimension.h"
+#include "BoidStore.h"
+#include "SpacePartition.h"
+#include <vector>
+
+//Picks the partition's cell width from the queries the boids are making.
+//Every so often it walks the cells a sample of boids would query, and from
+//how many candidates those cells held works out the density around each.
+//A query then costs a fixed price per cell looked up plus one per candidate
+//read, which for a box of side 2r in cells of width w comes to
+//(1 + 2r / w)^D cells holding density * (2r + w)^D candidates on average.
+//Small cells fit the query tightly but take many lookups, large ones take
+//few but hold more boids outside the radius. A new width is only suggested
+//once it is predicted to save a clear share, so the partition isn't
+//refiled back and forth over noise
+template<int D>
+class BasicCellWidthTuner
+{
+public:
+	using vec = VecN<D>;
+	//Price of looking up one cell, hashing its key and reading its list
+	//head, relative to reading and rejecting one candidate
+	static constexpr float cellCost = 4.0f;
+	//Share of the predicted cost a new width has to save
+	static constexpr float minSaving = 0.15f;
+	//Cells are never made narrower than this, however small the queries
+	static constexpr float minWidth = 1.0f;
+	static constexpr int sampleCount = 64;
+	//Widths tried, a quarter octave apart from an eighth of the mean query
+	//radius up to four times it
+	static constexpr int widthSteps = 21;
+
+	//What the model predicts an average query costs at a width
+	struct Estimate
+	{
+		float width = 0.0f;
+		float cells = 0.0f;
+		float candidates = 0.0f;
+		float cost = 0.0f;
+	};
+private:
+	int m_interval = 30;
+	int m_framesUntilTune = 0;
+	//First boid sampled, moved on each time so every boid is looked at
+	int m_nextSample = 0;
+	Estimate m_current;
+	Estimate m_best;
+	//Query radius and measured density per sample, kept between updates
+	//to avoid reallocating them
+	std::vector<float> m_radii;
+	std::vector<float> m_densities;
+
+	Estimate predict(float width) const;
+public:
+	//Counts a frame, sampling the boids' queries once the interval has
+	//passed. Returns the width the partition should use, which is its
+	//current one unless another is predicted to save at least minSaving
+	float update(const BasicBoidStore<D>& boids, const BasicSpacePartition<D>& partition);
+	//Makes the next update sample straight away
+	void restart() { m_framesUntilTune = 0; }
+
+	//Frames between samples
+	void setInterval(int frames) { m_interval = frames > 1 ? frames : 1; }
+	int getInterval() const { return m_interval; }
+
+	//Predictions at the partition's width and the cheapest one tried, as
+	//of the last sample
+	const Estimate& getCurrent() const { return m_current; }
+	const Estimate& getBest() const { return m_best; }
+};
+
+using CellWidthTuner = BasicCellWidthTuner<2>;
+using CellWidthTuner3D = BasicCellWidthTuner<3>;
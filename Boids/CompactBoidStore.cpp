@@ -0,0 +1,72 @@
+#include "CompactBoidStore.h"
+#include "BoidStore.h"
+#include "SpacePartition.h"
+
+#include <algorithm>
+#include <cmath>
+
+bool CompactBoidStore::encode(vec2 position, vec2 velocity, CompactBoid& packed) const
+{
+	vec2 steps = position * (1.0f / m_positionStep);
+	for (int axis = 0; axis < 2; axis++)
+	{
+		//The world is unbounded but the fixed point isn't. Written so NaN 
+		//fails too
+		float rounded = std::floor(steps[axis] + 0.5f);
+		if (!(rounded >= -2147483648.0f && rounded <= 2147483520.0f))
+			return false;
+		packed.position[axis] = (int32_t)rounded;
+	}
+
+	//Position on the unit diamond, 0 at +x, 1 at +y, 2 at -x and 3 at -y
+	float sum = std::fabs(velocity.x) + std::fabs(velocity.y);
+	float t = 0.0f;
+	if (sum > 0.0f)
+	{
+		float x = velocity.x / sum;
+		float y = velocity.y / sum;
+		if (y >= 0.0f)
+			t = x >= 0.0f ? y : 1.0f - x;
+		else
+			t = x < 0.0f ? 2.0f - y : 3.0f + x;
+	}
+	//Masking wraps a full turn back round to 0
+	packed.heading = (uint16_t)((int)(t * headingOne + 0.5f) & 0xffff);
+	float speed = velocity.mag() * (speedOne / m_speedScale) + 0.5f;
+	packed.speed = (uint16_t)std::min(speed, 65535.0f);
+	return true;
+}
+
+bool CompactBoidStore::quantize(BoidStore& boids, SpacePartition& partition)
+{
+	m_positionStep = partition.getPartitionWidth() / cellOne;
+	m_speedScale = 0.0f;
+	for (const BoidProfile& profile : boids.profiles)
+		m_speedScale = std::max(m_speedScale, profile.maxSpeed);
+	if (m_speedScale <= 0.0f)
+		m_speedScale = 1.0f;
+
+	int count = boids.size();
+	m_boids.resize(count);
+	bool fits = true;
+	for (int i = 0; i < count; i++)
+	{
+		CompactBoid packed;
+		if (!encode(boids.position[i], boids.velocity[i], packed))
+		{
+			fits = false;
+			continue;
+		}
+		m_boids[i] = packed;
+		boids.velocity[i] = decodeVelocity(packed);
+
+		//Snapping can nudge a boid over a cell edge
+		vec2 position = decodePosition(packed);
+		if (position != boids.position[i])
+		{
+			boids.position[i] = position;
+			partition.haveMoved(i, position);
+		}
+	}
+	return fits;
+}
@@ -0,0 +1,69 @@
+#pragma once
+
+#include "vec2.h"
+#include "vec3.h"
+
+//The simulation is compiled once per dimension. The 2D build keeps its state 
+//in vec2 over a planar grid and the 3D build in vec3 over a volumetric one, 
+//so neither carries the other's maths and nothing branches on dimension 
+//while stepping
+template<int D>
+struct Dimension;
+
+template<>
+struct Dimension<2>
+{
+	using vec = vec2;
+	static vec fromPlanar(vec2 planar) { return planar; }
+	static vec splat(float value) { return vec2(value, value); }
+};
+
+template<>
+struct Dimension<3>
+{
+	using vec = vec3;
+	//Planar input such as a click or the circle test lies on z = 0
+	static vec fromPlanar(vec2 planar) { return vec3(planar.x, planar.y, 0.0f); }
+	static vec splat(float value) { return vec3(value, value, value); }
+};
+
+template<int D>
+using VecN = typename Dimension<D>::vec;
+
+//Axis aligned box tests for the spatial indices, boxes given by their 
+//lowest and highest corners
+template<typename Vec>
+bool boxesOverlap(Vec loA, Vec hiA, Vec loB, Vec hiB)
+{
+	return loA.max(loB) == loA.max(loB).min(hiA.min(hiB));
+}
+template<typename Vec>
+bool boxContains(Vec lo, Vec hi, Vec point)
+{
+	return point.max(lo).min(hi) == point;
+}
+//Squared distance from a point to the nearest part of a box, 0 inside it
+template<typename Vec>
+float boxDistSq(Vec lo, Vec hi, Vec point)
+{
+	return (point.max(lo).min(hi) - point).square();
+}
+
+template<int D> struct BasicBoidStore;
+template<int D> class BasicObstacle;
+template<int D> class BasicSpacePartition;
+template<int D> class BasicObstacleIndex;
+template<int D> class BasicSimulation;
+
+//The app and most tools run the planar build
+using BoidStore = BasicBoidStore<2>;
+using Obstacle = BasicObstacle<2>;
+using SpacePartition = BasicSpacePartition<2>;
+using ObstacleIndex = BasicObstacleIndex<2>;
+using Simulation = BasicSimulation<2>;
+
+using BoidStore3D = BasicBoidStore<3>;
+using Obstacle3D = BasicObstacle<3>;
+using SpacePartition3D = BasicSpacePartition<3>;
+using ObstacleIndex3D = BasicObstacleIndex<3>;
+using Simulation3D = BasicSimulation<3>;
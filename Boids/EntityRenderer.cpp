@@ -0,0 +1,83 @@
+#include "EntityRenderer.h"
+#include "BoidStore.h"
+#include "Obstacle.h"
+#include "Shader.h"
+#include "Texture.h"
+#include "VertexArray.h"
+#include "glm/gtc/matrix_transform.hpp"
+
+EntityRenderer::EntityRenderer(Renderer& renderer, VertexArray& vao, IndexBuffer& ib, Shader& shader,
+	Texture& actorTex, Texture& obstacleTex, Texture& destinationTex,
+	Texture& outlineTexR, Texture& outlineTexB)
+	: m_renderer(renderer), m_vao(vao), m_ib(ib), m_shader(shader), m_actorTex(actorTex),
+	m_obstacleTex(obstacleTex), m_destinationTex(destinationTex), m_outlineR(outlineTexR), m_outlineB(outlineTexB)
+{
+}
+
+void EntityRenderer::drawQuad(const Texture& texture, glm::mat4 modelViewProjection)
+{
+	m_shader.bind();
+	texture.bind(0);
+	m_shader.setUniform1i("u_texture", 0);
+	m_shader.setUniformMat4f("u_modelViewProjection", modelViewProjection);
+
+	m_renderer.draw(m_vao, m_ib, m_shader);
+}
+
+void EntityRenderer::drawBoid(const BoidStore& boids, int boid, glm::mat4 viewProjection)
+{
+	vec2 position = boids.position[boid];
+	vec2 velocity = boids.velocity[boid];
+
+	//Get the rotation pivot
+	glm::vec3 worldUp = glm::vec3(0.0f, 1.0f, 0.0f);
+	glm::vec3 vel;
+	if (velocity != vec2())
+		vel = glm::normalize(glm::vec3(velocity.x, velocity.y, 0.0f));
+	else
+		vel = glm::vec3(1.0f);
+
+	glm::vec3 pivot = glm::normalize(glm::cross(worldUp, vel));
+
+	//Get rotation amount
+	float angle = glm::acos(glm::dot(vel, worldUp));
+
+	glm::mat4 scale = glm::scale(glm::mat4(1.0f), glm::vec3(boids.getProfile(boid).radius / 2));
+	glm::mat4 rotate = glm::rotate(glm::mat4(1.0f), angle, pivot);
+	glm::mat4 translate = glm::translate(
+		glm::mat4(1.0f), glm::vec3(position.x, position.y, 0.0f));
+
+	glm::mat4 model = translate * rotate * scale;
+	drawQuad(m_actorTex, viewProjection * model);
+}
+
+void EntityRenderer::drawAuras(const BoidStore& boids, int boid, glm::mat4 viewProjection,
+	bool drawAvoid, bool drawDetect)
+{
+	vec2 position = boids.position[boid];
+	glm::mat4 model = glm::translate(glm::mat4(1.0f), glm::vec3(position.x, position.y, 0.0f));
+	if (drawAvoid)
+	{
+		glm::mat4 scale = glm::scale(glm::mat4(1.0f), glm::vec3(boids.getProfile(boid).avoidanceDist / 2));
+		drawQuad(m_outlineR, viewProjection * model * scale);
+	}
+	if (drawDetect)
+	{
+		glm::mat4 scale = glm::scale(glm::mat4(1.0f), glm::vec3(boids.getProfile(boid).detectionDist / 2));
+		drawQuad(m_outlineB, viewProjection * model * scale);
+	}
+}
+
+void EntityRenderer::drawObstacle(const Obstacle& obstacle, glm::mat4 viewProjection)
+{
+	vec2 pos = obstacle.m_position;
+	glm::mat4 scale = glm::scale(glm::mat4(1.0f), glm::vec3(obstacle.m_radius / 2));
+	glm::mat4 model = glm::translate(glm::mat4(1.0f), glm::vec3(pos.x, pos.y, 0.0f));
+	drawQuad(m_obstacleTex, viewProjection * model * scale);
+}
+
+void EntityRenderer::drawDestination(vec2 destination, glm::mat4 viewProjection)
+{
+	glm::mat4 model = glm::translate(glm::mat4(1.0f), glm::vec3(destination.x, destination.y, 0.0f));
+	drawQuad(m_destinationTex, viewProjection * model);
+}
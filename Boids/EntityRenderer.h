@@ -0,0 +1,35 @@
+#pragma once
+
+#include "Renderer.h"
+#include "Dimension.h"
+#include "glm/glm.hpp"
+
+class Texture;
+
+//Holds the render resources shared by every entity so the simulation 
+//types don't need to know about OpenGL
+class EntityRenderer
+{
+private:
+	Renderer& m_renderer;
+	VertexArray& m_vao;
+	IndexBuffer& m_ib;
+	Shader& m_shader;
+	Texture& m_actorTex;
+	Texture& m_obstacleTex;
+	Texture& m_destinationTex;
+	Texture& m_outlineR;
+	Texture& m_outlineB;
+
+	void drawQuad(const Texture& texture, glm::mat4 modelViewProjection);
+public:
+	EntityRenderer(Renderer& renderer, VertexArray& vao, IndexBuffer& ib, Shader& shader,
+		Texture& actorTex, Texture& obstacleTex, Texture& destinationTex,
+		Texture& outlineTexR, Texture& outlineTexB);
+
+	void drawBoid(const BoidStore& boids, int boid, glm::mat4 viewProjection);
+	void drawAuras(const BoidStore& boids, int boid, glm::mat4 viewProjection,
+		bool drawAvoid, bool drawDetect);
+	void drawObstacle(const Obstacle& obstacle, glm::mat4 viewProjection);
+	void drawDestination(vec2 destination, glm::mat4 viewProjection);
+};
@@ -0,0 +1,42 @@
+#include "FrameArena.h"
+#include <algorithm>
+
+void* FrameArena::allocateSlow(size_t bytes, size_t alignment)
+{
+	//Move on to the next block kept from earlier frames if it's big enough, 
+	//otherwise put a new one in its place
+	size_t next = m_blocks.empty() ? 0 : m_current + 1;
+	size_t needed = bytes + alignment;
+	if (next >= m_blocks.size() || m_blocks[next].size < needed)
+	{
+		size_t size = std::max(defaultBlockSize, needed);
+		Block block = { std::unique_ptr<char[]>(new char[size]), size };
+		if (next < m_blocks.size())
+			m_blocks[next] = std::move(block);
+		else
+			m_blocks.push_back(std::move(block));
+	}
+	m_current = next;
+	m_offset = 0;
+	return allocate(bytes, alignment);
+}
+
+void FrameArena::reset()
+{
+	if (m_blocks.size() > 1)
+	{
+		size_t total = getCapacity();
+		m_blocks.clear();
+		m_blocks.push_back({ std::unique_ptr<char[]>(new char[total]), total });
+	}
+	m_current = 0;
+	m_offset = 0;
+}
+
+size_t FrameArena::getCapacity() const
+{
+	size_t total = 0;
+	for (const Block& block : m_blocks)
+		total += block.size;
+	return total;
+}
@@ -0,0 +1,97 @@
+#pragma once
+
+#include <cstddef>
+#include <memory>
+#include <vector>
+
+//Bump allocator for data that only lives within a steering pass. Memory 
+//comes from a few large blocks that are kept between frames, so once they 
+//have grown to a frame's needs steering makes no heap allocations. Nothing 
+//is freed individually, everything goes at once on reset or when a Scope ends. 
+//Cache line aligned as each steering thread bumps its own arena in an array
+class alignas(64) FrameArena
+{
+private:
+	struct Block
+	{
+		std::unique_ptr<char[]> data;
+		size_t size;
+	};
+
+	std::vector<Block> m_blocks;
+	//Block being carved up and the next free byte in it
+	size_t m_current = 0;
+	size_t m_offset = 0;
+
+	void* allocateSlow(size_t bytes, size_t alignment);
+public:
+	static constexpr size_t defaultBlockSize = 64 * 1024;
+
+	//Rewinds the arena to where it was when constructed, so temporary data 
+	//for one boid reuses the same cache-warm memory as the last
+	class Scope
+	{
+	private:
+		FrameArena& m_arena;
+		size_t m_block;
+		size_t m_offset;
+	public:
+		explicit Scope(FrameArena& arena)
+			: m_arena(arena), m_block(arena.m_current), m_offset(arena.m_offset) {}
+		~Scope()
+		{
+			m_arena.m_current = m_block;
+			m_arena.m_offset = m_offset;
+		}
+		Scope(const Scope&) = delete;
+		Scope& operator=(const Scope&) = delete;
+	};
+
+	//Alignment must be a power of two no larger than alignof(std::max_align_t)
+	void* allocate(size_t bytes, size_t alignment)
+	{
+		if (m_current < m_blocks.size())
+		{
+			size_t offset = (m_offset + alignment - 1) & ~(alignment - 1);
+			if (offset + bytes <= m_blocks[m_current].size)
+			{
+				m_offset = offset + bytes;
+				return m_blocks[m_current].data.get() + offset;
+			}
+		}
+		return allocateSlow(bytes, alignment);
+	}
+
+	//Releases everything. If the last frame spilled over into more than one 
+	//block they are merged, so the next frame fits in one
+	void reset();
+
+	size_t getCapacity() const;
+};
+
+//Lets standard containers allocate from a FrameArena. Deallocation does 
+//nothing, the memory is reclaimed when the arena rewinds
+template<typename T>
+class ArenaAllocator
+{
+private:
+	FrameArena* m_arena;
+
+	template<typename U> friend class ArenaAllocator;
+public:
+	using value_type = T;
+
+	explicit ArenaAllocator(FrameArena& arena) : m_arena(&arena) {}
+	template<typename U>
+	ArenaAllocator(const ArenaAllocator<U>& other) : m_arena(other.m_arena) {}
+
+	T* allocate(size_t count) { return static_cast<T*>(m_arena->allocate(count * sizeof(T), alignof(T))); }
+	void deallocate(T*, size_t) {}
+
+	FrameArena& getArena() const { return *m_arena; }
+
+	template<typename U>
+	bool operator==(const ArenaAllocator<U>& rhs) const { return m_arena == rhs.m_arena; }
+	template<typename U>
+	bool operator!=(const ArenaAllocator<U>& rhs) const { return m_arena != rhs.m_arena; }
+};
@@ -0,0 +1,67 @@
+#include "KdTree.h"
+#include <algorithm>
+
+template<int D>
+void BasicKdTree<D>::build(const std::vector<vec>& positions)
+{
+	int count = (int)positions.size();
+	m_nodes.clear();
+	m_actors.resize(count);
+	for (int i = 0; i < count; i++)
+		m_actors[i] = i;
+	if (count == 0)
+	{
+		m_points.clear();
+		return;
+	}
+
+	//A balanced tree has under twice as many nodes as leaves
+	m_nodes.reserve(2 * (count / leafSize + 1));
+	m_nodes.emplace_back();
+	buildNode(0, 0, count, positions);
+
+	m_points.resize(count);
+	for (int i = 0; i < count; i++)
+		m_points[i] = positions[m_actors[i]];
+}
+
+template<int D>
+void BasicKdTree<D>::buildNode(int node, int begin, int end, const std::vector<vec>& positions)
+{
+	vec lo = positions[m_actors[begin]];
+	vec hi = lo;
+	for (int i = begin + 1; i < end; i++)
+	{
+		lo = lo.min(positions[m_actors[i]]);
+		hi = hi.max(positions[m_actors[i]]);
+	}
+	//Written by index as adding children can move the nodes
+	m_nodes[node] = Node{ lo, hi, begin, end, -1 };
+	if (end - begin <= leafSize)
+		return;
+
+	vec extent = hi - lo;
+	int axis = 0;
+	for (int i = 1; i < D; i++)
+	{
+		if (extent[i] > extent[axis])
+			axis = i;
+	}
+	//Every actor in one place can't be split
+	if (extent[axis] <= 0.0f)
+		return;
+
+	int mid = begin + (end - begin) / 2;
+	std::nth_element(m_actors.begin() + begin, m_actors.begin() + mid, m_actors.begin() + end,
+		[&](int a, int b) { return positions[a][axis] < positions[b][axis]; });
+
+	int left = (int)m_nodes.size();
+	m_nodes[node].left = left;
+	m_nodes.emplace_back();
+	m_nodes.emplace_back();
+	buildNode(left, begin, mid, positions);
+	buildNode(left + 1, mid, end, positions);
+}
+
+template class BasicKdTree<2>;
+template class BasicKdTree<3>;
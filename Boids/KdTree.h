@@ -0,0 +1,96 @@
+#pragma once
+
+#include "Dimension.h"
+#include <vector>
+
+//Kd-tree over actor positions, split at the median of the widest axis
+//until leaves hold a handful of actors. Balanced however the actors are
+//spread, so tight clusters don't pile into a few huge cells the way they do
+//in a uniform grid. It can't be refiled in place, so updating rebuilds it.
+//Follows the spatial index interface in SpatialIndex.h
+template<int D>
+class BasicKdTree
+{
+public:
+	using vec = VecN<D>;
+	static const int leafSize = 8;
+private:
+	//Children are stored in adjacent nodes, so a node only needs its left
+	//one. Leaves have no children and own [begin, end) of the tree order
+	struct Node
+	{
+		vec lo, hi;
+		int begin, end;
+		int left;
+	};
+	//Deep enough for 2^64 actors as the tree is balanced
+	static const int maxDepth = 64;
+
+	std::vector<Node> m_nodes;
+	//Actors and their positions in tree order, so each leaf reads one run
+	std::vector<int> m_actors;
+	std::vector<vec> m_points;
+
+	void buildNode(int node, int begin, int end, const std::vector<vec>& positions);
+	template<typename Overlaps, typename Contains, typename Visit>
+	void query(Overlaps overlaps, Contains contains, Visit visit) const;
+public:
+	void build(const std::vector<vec>& positions);
+	void update(const std::vector<vec>& positions) { build(positions); }
+
+	template<typename Visit>
+	void queryRadius(vec centre, float radius, Visit visit) const;
+	template<typename Visit>
+	void queryBox(vec lo, vec hi, Visit visit) const;
+
+	int getNodeCount() const { return (int)m_nodes.size(); }
+};
+
+template<int D>
+template<typename Overlaps, typename Contains, typename Visit>
+void BasicKdTree<D>::query(Overlaps overlaps, Contains contains, Visit visit) const
+{
+	if (m_nodes.empty())
+		return;
+
+	int stack[maxDepth + 1];
+	int top = 0;
+	stack[top++] = 0;
+	while (top > 0)
+	{
+		const Node& node = m_nodes[stack[--top]];
+		if (!overlaps(node))
+			continue;
+		if (node.left < 0)
+		{
+			for (int i = node.begin; i < node.end; i++)
+			{
+				if (contains(m_points[i]))
+					visit(m_actors[i]);
+			}
+			continue;
+		}
+		stack[top++] = node.left + 1;
+		stack[top++] = node.left;
+	}
+}
+
+template<int D>
+template<typename Visit>
+void BasicKdTree<D>::queryRadius(vec centre, float radius, Visit visit) const
+{
+	float radiusSq = radius * radius;
+	query([&](const Node& node) { return boxDistSq(node.lo, node.hi, centre) <= radiusSq; },
+		[&](vec point) { return (point - centre).square() <= radiusSq; }, visit);
+}
+
+template<int D>
+template<typename Visit>
+void BasicKdTree<D>::queryBox(vec lo, vec hi, Visit visit) const
+{
+	query([&](const Node& node) { return boxesOverlap(node.lo, node.hi, lo, hi); },
+		[&](vec point) { return boxContains(lo, hi, point); }, visit);
+}
+
+using KdTree = BasicKdTree<2>;
+using KdTree3D = BasicKdTree<3>;
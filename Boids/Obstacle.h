@@ -1,24 +1,19 @@
 #pragma once
 
-#include "vec3.h"
-#include "SpacePartition.h"
+#include "Dimension.h"
 
-class Obstacle
+//A static disc, or sphere in 3D, boids steer around. Held by value in the 
+//simulation, which copies it into the obstacle index, filed in every 
+//cell it overlaps
+template<int D>
+class BasicObstacle
 {
-private:
-	SpacePartition& m_partition;
 public:
-	vec3 m_position;
+	VecN<D> m_position;
 	float m_radius;
 
-	Obstacle(vec3 position, float radius, SpacePartition& partition)
-		: m_position(position), m_radius(radius), m_partition(partition)
+	BasicObstacle(VecN<D> position, float radius)
+		: m_position(position), m_radius(radius)
 	{
-		m_partition.addObstacle(this);
 	}
-
-	~Obstacle()
-	{
-		m_partition.removeObstacle(this);
-	}
-};
\ No newline at end of file
+};
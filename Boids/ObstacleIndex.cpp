@@ -0,0 +1,67 @@
+#include "ObstacleIndex.h"
+
+template<int D>
+void BasicObstacleIndex<D>::build(const std::vector<BasicObstacle<D>>& obstacles, float cellWidth)
+{
+	clear();
+	m_cellWidth = cellWidth;
+	int count = (int)obstacles.size();
+	if (count == 0)
+		return;
+
+	//Count how many obstacles each cell gets, numbering cells as they come
+	m_ranges.resize(count);
+	m_fill.clear();
+	for (int i = 0; i < count; i++)
+	{
+		vec extent = Dimension<D>::splat(obstacles[i].m_radius);
+		m_ranges[i] = findCellRange(obstacles[i].m_position - extent, obstacles[i].m_position + extent);
+		forEachKey(m_ranges[i], [&](CellHash::Key key, int, int, int)
+		{
+			int cell = m_cells.insert(key);
+			if (cell == (int)m_fill.size())
+				m_fill.push_back(0);
+			m_fill[cell]++;
+		});
+	}
+
+	int cells = m_cells.size();
+	m_start.resize(cells + 1);
+	m_start[0] = 0;
+	for (int cell = 0; cell < cells; cell++)
+		m_start[cell + 1] = m_start[cell] + m_fill[cell];
+
+	//Then copy each obstacle into its cells' runs
+	m_entries.resize(m_start[cells]);
+	std::copy(m_start.begin(), m_start.end() - 1, m_fill.begin());
+	for (int i = 0; i < count; i++)
+	{
+		Entry entry;
+		entry.position = obstacles[i].m_position;
+		entry.radius = obstacles[i].m_radius;
+		entry.obstacle = i;
+		for (int axis = 0; axis < D; axis++)
+			entry.firstCell[axis] = m_ranges[i].bl[axis];
+		forEachKey(m_ranges[i], [&](CellHash::Key key, int, int, int)
+		{
+			m_entries[m_fill[m_cells.find(key)]++] = entry;
+		});
+	}
+}
+
+template<int D>
+void BasicObstacleIndex<D>::clear()
+{
+	m_cells.clear();
+	m_start.clear();
+	m_entries.clear();
+}
+
+template<int D>
+BasicObstacleIndex<D>::BasicObstacleIndex()
+	: m_cellWidth(1.0f)
+{
+}
+
+template class BasicObstacleIndex<2>;
+template class BasicObstacleIndex<3>;
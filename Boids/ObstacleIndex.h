@@ -0,0 +1,108 @@
+#pragma once
+
+#include "Dimension.h"
+#include "Obstacle.h"
+#include "SpacePartition.h"
+#include "CellHash.h"
+#include <vector>
+#include <algorithm>
+
+//Grid of the static obstacles, kept apart from the partition as obstacles
+//never move. Each obstacle is filed in every cell its disc, or sphere,
+//overlaps, so a query finds large obstacles reaching in from cells it
+//doesn't cover. Cells are runs of one flat array holding copies of the
+//obstacles, so a query reads them without going back to the simulation's
+//list. Built in one go and built again from scratch whenever the
+//obstacles change
+template<int D>
+class BasicObstacleIndex
+{
+public:
+	using vec = VecN<D>;
+	using Range = CellRange<D>;
+	struct Entry
+	{
+		vec position;
+		float radius;
+		//Index into the obstacle list the index was built from
+		int obstacle;
+		//Lowest cell per axis the obstacle was filed in. A query covering
+		//several of its cells only reports it from the lowest of those
+		int firstCell[D];
+	};
+private:
+	float m_cellWidth;
+	CellHash m_cells;
+	//Cell c holds m_entries[m_start[c], m_start[c + 1])
+	std::vector<int> m_start;
+	std::vector<Entry> m_entries;
+	//Kept between builds to avoid reallocating them
+	std::vector<Range> m_ranges;
+	std::vector<int> m_fill;
+
+	Range findCellRange(vec lo, vec hi) const { return makeCellRange<D>(lo, hi, m_cellWidth); }
+	//Calls visit(key, x, y, z) for every cell in the range, z being 0 in 2D
+	template<typename Visit>
+	static void forEachKey(const Range& range, Visit visit);
+public:
+	void build(const std::vector<BasicObstacle<D>>& obstacles, float cellWidth);
+	void clear();
+
+	//Calls visit(entry) once for every obstacle whose disc overlaps the
+	//box around the circle or sphere. Some may lie just outside the circle
+	//itself, so callers still check distances
+	template<typename Visit>
+	void query(vec centre, float radius, Visit visit) const;
+
+	float getCellWidth() const { return m_cellWidth; }
+	int getStoredCells() const { return m_cells.size(); }
+	//Obstacles filed more than once are counted per cell
+	int getEntryCount() const { return (int)m_entries.size(); }
+
+	BasicObstacleIndex();
+};
+
+template<int D>
+template<typename Visit>
+void BasicObstacleIndex<D>::forEachKey(const Range& range, Visit visit)
+{
+	int zBegin = D == 3 ? range.bl[D - 1] : 0;
+	int zEnd = D == 3 ? range.tr[D - 1] : 1;
+	for (int z = zBegin; z < zEnd; z++)
+	{
+		for (int y = range.bl[1]; y < range.tr[1]; y++)
+		{
+			//X is the low part of the key, and the range is already clamped
+			CellHash::Key key = CellHash::makeKey(range.bl[0], y, z);
+			for (int x = range.bl[0]; x < range.tr[0]; x++, key++)
+				visit(key, x, y, z);
+		}
+	}
+}
+
+template<int D>
+template<typename Visit>
+void BasicObstacleIndex<D>::query(vec centre, float radius, Visit visit) const
+{
+	if (m_entries.empty())
+		return;
+
+	vec extent = Dimension<D>::splat(radius);
+	Range range = findCellRange(centre - extent, centre + extent);
+	forEachKey(range, [&](CellHash::Key key, int x, int y, int z)
+	{
+		int cell = m_cells.find(key);
+		if (cell < 0)
+			return;
+		int coords[3] = { x, y, z };
+		for (int i = m_start[cell]; i < m_start[cell + 1]; i++)
+		{
+			const Entry& entry = m_entries[i];
+			bool first = true;
+			for (int axis = 0; axis < D; axis++)
+				first &= std::max(entry.firstCell[axis], range.bl[axis]) == coords[axis];
+			if (first)
+				visit(entry);
+		}
+	});
+}
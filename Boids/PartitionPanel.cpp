@@ -0,0 +1,76 @@
+#include "PartitionPanel.h"
+#include "SpacePartition.h"
+#include "Profiler.h"
+#include "imgui/imgui.h"
+#include <algorithm>
+
+static bool s_showHeatmap = false;
+
+static ImVec2 worldToScreen(const glm::mat4& viewProjection, float x, float y, int screenWidth, int screenHeight)
+{
+	glm::vec4 clip = viewProjection * glm::vec4(x, y, 0.0f, 1.0f);
+	return ImVec2((clip.x + 1.0f) * 0.5f * screenWidth, (1.0f - clip.y) * 0.5f * screenHeight);
+}
+
+static void drawHeatmap(const SpacePartition& partition, const OccupancyStats& stats, 
+	const glm::mat4& viewProjection, int screenWidth, int screenHeight)
+{
+	if (stats.maxActors == 0)
+		return;
+
+	ImDrawList* drawList = ImGui::GetOverlayDrawList();
+	float width = partition.getPartitionWidth();
+	partition.forEachStoredCell([&](int x, int y, int, int actors)
+	{
+		if (actors == 0)
+			return;
+		//Scale from cool to hot against the fullest cell
+		float heat = (float)actors / stats.maxActors;
+		ImU32 colour = ImGui::GetColorU32(ImVec4(heat, 0.2f, 1.0f - heat, 0.15f + 0.45f * heat));
+		float left = x * width;
+		float bottom = y * width;
+		ImVec2 a = worldToScreen(viewProjection, left, bottom + width, screenWidth, screenHeight);
+		ImVec2 b = worldToScreen(viewProjection, left + width, bottom, screenWidth, screenHeight);
+		drawList->AddRectFilled(a, b, colour);
+	});
+}
+
+void drawPartitionPanel(const SpacePartition& partition, const glm::mat4& viewProjection, 
+	int screenWidth, int screenHeight)
+{
+	OccupancyStats stats = partition.computeOccupancy();
+
+	ImGui::Begin("Partition");
+	ImGui::Text("Cells stored %d, cell width %.1f", stats.storedCells, partition.getPartitionWidth());
+	ImGui::Text("Stored objects %d, actors %d", partition.getStoredObjects(), stats.totalActors);
+	ImGui::Text("Occupied cells %d, mean %.2f actors per occupied cell", stats.occupiedCells, stats.meanOccupied);
+	ImGui::Text("Hottest cell (%d, %d) with %d actors", stats.maxCellX, stats.maxCellY, stats.maxActors);
+
+	float histogram[OccupancyStats::bucketCount];
+	for (int i = 0; i < OccupancyStats::bucketCount; i++)
+		histogram[i] = (float)stats.histogram[i];
+	ImGui::PlotHistogram("##Occupancy", histogram, OccupancyStats::bucketCount, 0, 
+		"Cells by actor count: 0, 1, 2, 4 ... 64+", 0.0f, FLT_MAX, ImVec2(0, 80));
+
+	//Work counters gathered during the last frames
+#if !BOIDS_PROFILING
+	ImGui::Text("Partition counters are compiled out, define BOIDS_PROFILING=1 to enable them");
+#endif
+	Profiler& profiler = Profiler::get();
+	for (int i = 0; i <= (int)ProfileCounter::cellMoves; i++)
+	{
+		Profiler::Stats counter = profiler.getCounterStats((ProfileCounter)i);
+		ImGui::Text("%s: avg %.0f  p99 %.0f per frame", Profiler::getCounterName((ProfileCounter)i), 
+			counter.average, counter.p99);
+	}
+	Profiler::Stats queries = profiler.getCounterStats(ProfileCounter::partitionQueries);
+	Profiler::Stats cells = profiler.getCounterStats(ProfileCounter::cellsVisited);
+	if (queries.average > 0.0f)
+		ImGui::Text("Cells visited per query %.2f", cells.average / queries.average);
+
+	ImGui::Checkbox("Show heatmap", &s_showHeatmap);
+	ImGui::End();
+
+	if (s_showHeatmap)
+		drawHeatmap(partition, stats, viewProjection, screenWidth, screenHeight);
+}
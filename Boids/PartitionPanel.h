@@ -0,0 +1,7 @@
+#pragma once
+#include "Dimension.h"
+#include "glm/glm.hpp"
+
+//Draws the partition occupancy window and, when enabled, a per-cell heatmap over the scene
+void drawPartitionPanel(const SpacePartition& partition, const glm::mat4& viewProjection, 
+	int screenWidth, int screenHeight);
@@ -0,0 +1,165 @@
+#include "PerfCounters.h"
+
+#ifdef __linux__
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#include <cerrno>
+#include <cstring>
+#include <cstdint>
+#endif
+
+PerfCounters::Sample PerfCounters::Sample::operator-(const Sample& rhs) const
+{
+	Sample result;
+	for (int i = 0; i < counterCount; i++)
+	{
+		result.valid[i] = valid[i] && rhs.valid[i];
+		result.values[i] = result.valid[i] ? values[i] - rhs.values[i] : 0.0;
+	}
+	return result;
+}
+
+PerfCounters::Sample& PerfCounters::Sample::operator+=(const Sample& rhs)
+{
+	for (int i = 0; i < counterCount; i++)
+	{
+		valid[i] = valid[i] && rhs.valid[i];
+		values[i] += rhs.values[i];
+	}
+	return *this;
+}
+
+PerfCounters::PerfCounters()
+{
+	for (int i = 0; i < counterCount; i++)
+		m_fds[i] = -1;
+}
+
+PerfCounters::~PerfCounters()
+{
+	close();
+}
+
+bool PerfCounters::isAvailable() const
+{
+	for (int i = 0; i < counterCount; i++)
+	{
+		if (m_fds[i] >= 0)
+			return true;
+	}
+	return false;
+}
+
+PerfCounters::Sample PerfCounters::emptySample()
+{
+	Sample sample;
+	for (int i = 0; i < counterCount; i++)
+	{
+		sample.valid[i] = true;
+		sample.values[i] = 0.0;
+	}
+	return sample;
+}
+
+const char* PerfCounters::getCounterName(PerfCounter counter)
+{
+	switch (counter)
+	{
+	case PerfCounter::cycles:
+		return "cycles";
+	case PerfCounter::instructions:
+		return "instructions";
+	case PerfCounter::cacheMisses:
+		return "cache-misses";
+	case PerfCounter::branchMisses:
+		return "branch-misses";
+	case PerfCounter::llcLoads:
+		return "LLC-loads";
+	default:
+		return "unknown";
+	}
+}
+
+#ifdef __linux__
+
+bool PerfCounters::open()
+{
+	close();
+
+	const uint32_t types[counterCount] = { PERF_TYPE_HARDWARE, PERF_TYPE_HARDWARE, 
+		PERF_TYPE_HARDWARE, PERF_TYPE_HARDWARE, PERF_TYPE_HW_CACHE };
+	const uint64_t configs[counterCount] = { PERF_COUNT_HW_CPU_CYCLES, PERF_COUNT_HW_INSTRUCTIONS,
+		PERF_COUNT_HW_CACHE_MISSES, PERF_COUNT_HW_BRANCH_MISSES,
+		PERF_COUNT_HW_CACHE_LL | (PERF_COUNT_HW_CACHE_OP_READ << 8) | (PERF_COUNT_HW_CACHE_RESULT_ACCESS << 16) };
+
+	for (int i = 0; i < counterCount; i++)
+	{
+		perf_event_attr attr;
+		std::memset(&attr, 0, sizeof(attr));
+		attr.size = sizeof(attr);
+		attr.type = types[i];
+		attr.config = configs[i];
+		attr.exclude_kernel = 1;
+		attr.exclude_hv = 1;
+		//Count threads started later too, such as the steering workers
+		attr.inherit = 1;
+		attr.read_format = PERF_FORMAT_TOTAL_TIME_ENABLED | PERF_FORMAT_TOTAL_TIME_RUNNING;
+
+		m_fds[i] = (int)syscall(SYS_perf_event_open, &attr, 0, -1, -1, 0);
+		if (m_fds[i] < 0 && m_error.empty())
+			m_error = std::string(getCounterName((PerfCounter)i)) + ": " + std::strerror(errno);
+	}
+	return isAvailable();
+}
+
+void PerfCounters::close()
+{
+	for (int i = 0; i < counterCount; i++)
+	{
+		if (m_fds[i] >= 0)
+			::close(m_fds[i]);
+		m_fds[i] = -1;
+	}
+	m_error.clear();
+}
+
+PerfCounters::Sample PerfCounters::read() const
+{
+	Sample sample;
+	for (int i = 0; i < counterCount; i++)
+	{
+		uint64_t data[3] = { 0, 0, 0 };
+		sample.valid[i] = m_fds[i] >= 0 && ::read(m_fds[i], data, sizeof(data)) == (ssize_t)sizeof(data);
+		sample.values[i] = 0.0;
+		if (sample.valid[i] && data[2] > 0)
+			sample.values[i] = (double)data[0] * ((double)data[1] / (double)data[2]);
+	}
+	return sample;
+}
+
+#else
+
+bool PerfCounters::open()
+{
+	m_error = "hardware counters are only supported on Linux";
+	return false;
+}
+
+void PerfCounters::close()
+{
+}
+
+PerfCounters::Sample PerfCounters::read() const
+{
+	Sample sample;
+	for (int i = 0; i < counterCount; i++)
+	{
+		sample.valid[i] = false;
+		sample.values[i] = 0.0;
+	}
+	return sample;
+}
+
+#endif
@@ -0,0 +1,53 @@
+#pragma once
+
+#include <string>
+
+enum class PerfCounter
+{
+	cycles,
+	instructions,
+	cacheMisses,
+	branchMisses,
+	llcLoads,
+	count
+};
+
+//Linux hardware performance counters for the calling thread and any 
+//threads it starts afterwards. Anywhere perf_event_open is missing or 
+//denied (other platforms, containers, perf_event_paranoid) the counters 
+//report as unavailable and reads return invalid samples
+class PerfCounters
+{
+public:
+	static const int counterCount = (int)PerfCounter::count;
+
+	struct Sample
+	{
+		bool valid[counterCount];
+		double values[counterCount];
+
+		Sample operator-(const Sample& rhs) const;
+		Sample& operator+=(const Sample& rhs);
+	};
+private:
+	int m_fds[counterCount];
+	std::string m_error;
+public:
+	PerfCounters();
+	~PerfCounters();
+	PerfCounters(const PerfCounters&) = delete;
+	PerfCounters& operator=(const PerfCounters&) = delete;
+
+	//Opens every counter it can. Returns false if none could be opened
+	bool open();
+	void close();
+	bool isAvailable() const;
+	bool isAvailable(PerfCounter counter) const { return m_fds[(int)counter] >= 0; }
+	const std::string& getError() const { return m_error; }
+
+	//Running totals, scaled up if the kernel had to multiplex the counters
+	Sample read() const;
+
+	static Sample emptySample();
+	static const char* getCounterName(PerfCounter counter);
+};
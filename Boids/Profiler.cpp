@@ -0,0 +1,150 @@
+#include "Profiler.h"
+#include <algorithm>
+
+thread_local CounterBatch* CounterBatch::s_current = nullptr;
+
+CounterBatch::~CounterBatch()
+{
+	for (int i = 0; i < (int)ProfileCounter::count; i++)
+	{
+		if (m_counts[i] > 0)
+			Profiler::get().addCount((ProfileCounter)i, m_counts[i]);
+	}
+	s_current = m_outer;
+}
+
+Profiler::Profiler()
+{
+	reset();
+}
+
+Profiler& Profiler::get()
+{
+	static Profiler profiler;
+	return profiler;
+}
+
+const char* Profiler::getPhaseName(ProfilePhase phase)
+{
+	switch (phase)
+	{
+	case ProfilePhase::steering:
+		return "Steering";
+	case ProfilePhase::cellWidthTuning:
+		return "  Cell width tuning";
+	case ProfilePhase::quantize:
+		return "  Quantize state";
+	case ProfilePhase::indexUpdate:
+		return "  Index update";
+	case ProfilePhase::obstacleIndex:
+		return "  Obstacle index";
+	case ProfilePhase::dataCollection:
+		return "  Data collection";
+	case ProfilePhase::voConstruction:
+		return "  VO construction";
+	case ProfilePhase::clearPathSampling:
+		return "  Clear path sampling";
+	case ProfilePhase::locomotion:
+		return "Locomotion + partition";
+	case ProfilePhase::reorder:
+		return "  Morton reorder";
+	case ProfilePhase::partitionRebuild:
+		return "  Partition rebuild";
+	case ProfilePhase::boidDraw:
+		return "Boid draw";
+	case ProfilePhase::auraDraw:
+		return "Aura draw";
+	case ProfilePhase::obstacleDraw:
+		return "Obstacle draw";
+	default:
+		return "Unknown";
+	}
+}
+
+const char* Profiler::getCounterName(ProfileCounter counter)
+{
+	switch (counter)
+	{
+	case ProfileCounter::partitionQueries:
+		return "Partition queries";
+	case ProfileCounter::cellsVisited:
+		return "Cells visited";
+	case ProfileCounter::cellMoves:
+		return "Cell moves";
+	case ProfileCounter::actorCandidates:
+		return "collectFromActors visited";
+	case ProfileCounter::actorsAccepted:
+		return "collectFromActors accepted";
+	case ProfileCounter::obstacleCandidates:
+		return "collectFromObstacles visited";
+	case ProfileCounter::obstaclesAccepted:
+		return "collectFromObstacles accepted";
+	case ProfileCounter::actorVOCandidates:
+		return "getActorVOs visited";
+	case ProfileCounter::actorVOsBuilt:
+		return "getActorVOs built";
+	case ProfileCounter::obstacleVOCandidates:
+		return "getObstacleVOs visited";
+	case ProfileCounter::obstacleVOsBuilt:
+		return "getObstacleVOs built";
+	case ProfileCounter::voCollections:
+		return "VO collections";
+	default:
+		return "Unknown";
+	}
+}
+
+void Profiler::endFrame()
+{
+	auto now = std::chrono::steady_clock::now();
+	for (int i = 0; i < phaseCount; i++)
+		m_phaseHistory[i][m_historyPos] = m_accumulated[i].exchange(0, std::memory_order_relaxed) / 1e6f;
+	for (int i = 0; i < counterCount; i++)
+		m_counterHistory[i][m_historyPos] = (float)m_counts[i].exchange(0, std::memory_order_relaxed);
+	m_frameHistory[m_historyPos] = std::chrono::duration<float, std::milli>(now - m_frameStart).count();
+	m_frameStart = now;
+
+	m_historyPos = (m_historyPos + 1) % historySize;
+	m_historyCount = std::min(m_historyCount + 1, historySize);
+
+	TraceRecorder::get().endFrame();
+}
+
+void Profiler::reset()
+{
+	for (int i = 0; i < phaseCount; i++)
+	{
+		m_accumulated[i].store(0, std::memory_order_relaxed);
+		std::fill(m_phaseHistory[i], m_phaseHistory[i] + historySize, 0.0f);
+	}
+	for (int i = 0; i < counterCount; i++)
+	{
+		m_counts[i].store(0, std::memory_order_relaxed);
+		std::fill(m_counterHistory[i], m_counterHistory[i] + historySize, 0.0f);
+	}
+	std::fill(m_frameHistory, m_frameHistory + historySize, 0.0f);
+	m_historyPos = 0;
+	m_historyCount = 0;
+	m_frameStart = std::chrono::steady_clock::now();
+}
+
+Profiler::Stats Profiler::computeStats(const float* history) const
+{
+	Stats stats = { 0.0f, 0.0f, 0.0f, 0.0f };
+	if (m_historyCount == 0)
+		return stats;
+
+	float sorted[historySize];
+	std::copy(history, history + m_historyCount, sorted);
+	std::sort(sorted, sorted + m_historyCount);
+
+	float sum = 0.0f;
+	for (int i = 0; i < m_historyCount; i++)
+		sum += sorted[i];
+
+	stats.last = history[(m_historyPos + historySize - 1) % historySize];
+	stats.average = sum / m_historyCount;
+	stats.p50 = sorted[(m_historyCount - 1) / 2];
+	stats.p99 = sorted[(m_historyCount - 1) * 99 / 100];
+	return stats;
+}
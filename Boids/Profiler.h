@@ -0,0 +1,211 @@
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include "TraceRecorder.h"
+
+//Scoped timers are compiled in by default for debug builds only. Define 
+//BOIDS_PROFILING=1 to keep them in an optimised build
+#ifndef BOIDS_PROFILING
+#ifdef NDEBUG
+#define BOIDS_PROFILING 0
+#else
+#define BOIDS_PROFILING 1
+#endif
+#endif
+
+enum class ProfilePhase
+{
+	steering,
+	cellWidthTuning,
+	quantize,
+	indexUpdate,
+	obstacleIndex,
+	dataCollection,
+	voConstruction,
+	clearPathSampling,
+	locomotion,
+	reorder,
+	partitionRebuild,
+	boidDraw,
+	auraDraw,
+	obstacleDraw,
+	count
+};
+
+//Work counters reported per frame alongside the phase timings
+enum class ProfileCounter
+{
+	partitionQueries,
+	cellsVisited,
+	cellMoves,
+	//Neighbour candidates looked at versus kept by each steering helper
+	actorCandidates,
+	actorsAccepted,
+	obstacleCandidates,
+	obstaclesAccepted,
+	actorVOCandidates,
+	actorVOsBuilt,
+	obstacleVOCandidates,
+	obstacleVOsBuilt,
+	//Boids that gathered velocity obstacles, for VOs per boid
+	voCollections,
+	count
+};
+
+//Collects per-phase time for the current frame and keeps a short history 
+//of completed frames. Phases timed in each worker are summed across threads
+class Profiler
+{
+public:
+	static constexpr int historySize = 240;
+
+	struct Stats
+	{
+		float last;
+		float average;
+		float p50;
+		float p99;
+	};
+private:
+	static const int phaseCount = (int)ProfilePhase::count;
+	static const int counterCount = (int)ProfileCounter::count;
+
+	std::atomic<uint64_t> m_accumulated[phaseCount];
+	std::atomic<uint64_t> m_counts[counterCount];
+	//Milliseconds per frame, written as a ring buffer
+	float m_phaseHistory[phaseCount][historySize];
+	float m_counterHistory[counterCount][historySize];
+	float m_frameHistory[historySize];
+	int m_historyPos = 0;
+	int m_historyCount = 0;
+	std::chrono::steady_clock::time_point m_frameStart;
+
+	Stats computeStats(const float* history) const;
+public:
+	Profiler();
+
+	static Profiler& get();
+	static const char* getPhaseName(ProfilePhase phase);
+	static const char* getCounterName(ProfileCounter counter);
+
+	void add(ProfilePhase phase, uint64_t nanoseconds)
+	{
+		m_accumulated[(int)phase].fetch_add(nanoseconds, std::memory_order_relaxed);
+	}
+	void addCount(ProfileCounter counter, uint64_t amount)
+	{
+		m_counts[(int)counter].fetch_add(amount, std::memory_order_relaxed);
+	}
+
+	//Moves the current frame's totals into the history and starts a new frame
+	void endFrame();
+	void reset();
+
+	Stats getPhaseStats(ProfilePhase phase) const { return computeStats(m_phaseHistory[(int)phase]); }
+	Stats getCounterStats(ProfileCounter counter) const { return computeStats(m_counterHistory[(int)counter]); }
+	Stats getFrameStats() const { return computeStats(m_frameHistory); }
+	int getHistoryCount() const { return m_historyCount; }
+	//Ring buffer of frame times, oldest entry at getHistoryOffset()
+	const float* getFrameHistory() const { return m_frameHistory; }
+	int getHistoryOffset() const { return m_historyCount < historySize ? 0 : m_historyPos; }
+};
+
+//Sums counts for the length of a scope, such as one worker's range of 
+//boids, and adds them to the profiler once when it closes. Counts made on 
+//a thread go to the innermost batch open on it, or straight to the shared 
+//totals if there is none, so threads don't contend on them per boid
+class CounterBatch
+{
+private:
+	uint64_t m_counts[(int)ProfileCounter::count] = {};
+	CounterBatch* m_outer;
+	static thread_local CounterBatch* s_current;
+public:
+	CounterBatch() : m_outer(s_current) { s_current = this; }
+	~CounterBatch();
+	CounterBatch(const CounterBatch&) = delete;
+	CounterBatch& operator=(const CounterBatch&) = delete;
+
+	static void add(ProfileCounter counter, uint64_t amount)
+	{
+		if (s_current)
+			s_current->m_counts[(int)counter] += amount;
+		else
+			Profiler::get().addCount(counter, amount);
+	}
+};
+
+//Sums one phase's time over many short scopes, such as each chunk of a 
+//worker's range, and adds it to the profiler once when it goes out of scope
+class PhaseTotal
+{
+private:
+	ProfilePhase m_phase;
+	uint64_t m_nanoseconds = 0;
+public:
+	explicit PhaseTotal(ProfilePhase phase) : m_phase(phase) {}
+	~PhaseTotal()
+	{
+		if (m_nanoseconds > 0)
+			Profiler::get().add(m_phase, m_nanoseconds);
+	}
+	PhaseTotal(const PhaseTotal&) = delete;
+	PhaseTotal& operator=(const PhaseTotal&) = delete;
+
+	ProfilePhase getPhase() const { return m_phase; }
+	void add(uint64_t nanoseconds) { m_nanoseconds += nanoseconds; }
+};
+
+//Adds its lifetime to the profiler, or to a PhaseTotal if given one, and 
+//while a trace is being captured records it as a trace event
+class ScopedTimer
+{
+private:
+	ProfilePhase m_phase;
+	PhaseTotal* m_total;
+	bool m_hasPosition;
+	float m_position[2];
+	std::chrono::steady_clock::time_point m_start;
+public:
+	explicit ScopedTimer(ProfilePhase phase) 
+		: m_phase(phase), m_total(nullptr), m_hasPosition(false), m_position{ 0.0f, 0.0f }, 
+		m_start(std::chrono::steady_clock::now()) {}
+	ScopedTimer(PhaseTotal& total, float x, float y)
+		: m_phase(total.getPhase()), m_total(&total), m_hasPosition(true), m_position{ x, y }, 
+		m_start(std::chrono::steady_clock::now()) {}
+	~ScopedTimer()
+	{
+		auto end = std::chrono::steady_clock::now();
+		uint64_t nanoseconds = (uint64_t)std::chrono::duration_cast<std::chrono::nanoseconds>(end - m_start).count();
+		if (m_total)
+			m_total->add(nanoseconds);
+		else
+			Profiler::get().add(m_phase, nanoseconds);
+		TraceRecorder& recorder = TraceRecorder::get();
+		if (recorder.isCapturing())
+			recorder.record(m_phase, m_start, end, m_hasPosition ? m_position : nullptr);
+	}
+};
+
+#if BOIDS_PROFILING
+#define PROFILE_CONCAT_INNER(a, b) a##b
+#define PROFILE_CONCAT(a, b) PROFILE_CONCAT_INNER(a, b)
+#define PROFILE_SCOPE(phase) ScopedTimer PROFILE_CONCAT(profileTimer, __LINE__)(phase)
+//Sums a phase over the PROFILE_SCOPE_INTO_AT scopes that name it, adding 
+//the total to the profiler at the end of the enclosing scope
+#define PROFILE_TOTAL(name, phase) PhaseTotal name(phase)
+//Times the enclosing scope into a PROFILE_TOTAL, tagging its trace event 
+//with a world position
+#define PROFILE_SCOPE_INTO_AT(total, x, y) ScopedTimer PROFILE_CONCAT(profileTimer, __LINE__)(total, x, y)
+#define PROFILE_COUNT(counter, amount) CounterBatch::add(counter, amount)
+//Batches the counts made until the end of the enclosing scope
+#define PROFILE_COUNT_BATCH() CounterBatch PROFILE_CONCAT(profileCounts, __LINE__)
+#else
+#define PROFILE_SCOPE(phase)
+#define PROFILE_TOTAL(name, phase)
+#define PROFILE_SCOPE_INTO_AT(total, x, y)
+#define PROFILE_COUNT(counter, amount)
+#define PROFILE_COUNT_BATCH()
+#endif
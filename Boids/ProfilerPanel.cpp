@@ -0,0 +1,115 @@
+#include "ProfilerPanel.h"
+#include "Profiler.h"
+#include "TraceRecorder.h"
+#include "imgui/imgui.h"
+#include <iostream>
+
+static int s_traceFrames = 60;
+static bool s_tracePending = false;
+static const char* s_tracePath = "trace.json";
+
+//One row of the neighbour query table, average candidates per frame and the share kept
+static void drawQueryRow(const char* name, ProfileCounter visited, ProfileCounter accepted)
+{
+	Profiler& profiler = Profiler::get();
+	float visitedAverage = profiler.getCounterStats(visited).average;
+	float acceptedAverage = profiler.getCounterStats(accepted).average;
+	ImGui::Text("%s", name);
+	ImGui::NextColumn();
+	ImGui::Text("%.0f", visitedAverage);
+	ImGui::NextColumn();
+	ImGui::Text("%.0f", acceptedAverage);
+	ImGui::NextColumn();
+	if (visitedAverage > 0.0f)
+		ImGui::Text("%.1f%%", 100.0f * acceptedAverage / visitedAverage);
+	else
+		ImGui::Text("-");
+	ImGui::NextColumn();
+}
+
+void drawProfilerPanel()
+{
+	Profiler& profiler = Profiler::get();
+
+	ImGui::Begin("Profiler");
+#if !BOIDS_PROFILING
+	ImGui::Text("Phase timers are compiled out, define BOIDS_PROFILING=1 to enable them");
+#endif
+	Profiler::Stats frame = profiler.getFrameStats();
+	ImGui::Text("Frame: avg %.3f ms  p50 %.3f ms  p99 %.3f ms", frame.average, frame.p50, frame.p99);
+	ImGui::PlotLines("##FrameTimes", profiler.getFrameHistory(), profiler.getHistoryCount(),
+		profiler.getHistoryOffset(), "Frame time (ms)", 0.0f, FLT_MAX, ImVec2(0, 80));
+
+	ImGui::Columns(5, "PhaseTimes");
+	ImGui::Text("Phase (ms)");
+	ImGui::NextColumn();
+	ImGui::Text("Last");
+	ImGui::NextColumn();
+	ImGui::Text("Avg");
+	ImGui::NextColumn();
+	ImGui::Text("p50");
+	ImGui::NextColumn();
+	ImGui::Text("p99");
+	ImGui::NextColumn();
+	ImGui::Separator();
+	for (int i = 0; i < (int)ProfilePhase::count; i++)
+	{
+		Profiler::Stats stats = profiler.getPhaseStats((ProfilePhase)i);
+		ImGui::Text("%s", Profiler::getPhaseName((ProfilePhase)i));
+		ImGui::NextColumn();
+		ImGui::Text("%.3f", stats.last);
+		ImGui::NextColumn();
+		ImGui::Text("%.3f", stats.average);
+		ImGui::NextColumn();
+		ImGui::Text("%.3f", stats.p50);
+		ImGui::NextColumn();
+		ImGui::Text("%.3f", stats.p99);
+		ImGui::NextColumn();
+	}
+	ImGui::Columns(1);
+	ImGui::Text("Per-boid phases are summed across steering threads");
+
+	//How much of the neighbour search is discarded by the distance and view arc tests
+	ImGui::Columns(4, "NeighbourQueries");
+	ImGui::Text("Query (per frame)");
+	ImGui::NextColumn();
+	ImGui::Text("Visited");
+	ImGui::NextColumn();
+	ImGui::Text("Accepted");
+	ImGui::NextColumn();
+	ImGui::Text("Kept");
+	ImGui::NextColumn();
+	ImGui::Separator();
+	drawQueryRow("collectFromActors", ProfileCounter::actorCandidates, ProfileCounter::actorsAccepted);
+	drawQueryRow("collectFromObstacles", ProfileCounter::obstacleCandidates, ProfileCounter::obstaclesAccepted);
+	drawQueryRow("getActorVOs", ProfileCounter::actorVOCandidates, ProfileCounter::actorVOsBuilt);
+	drawQueryRow("getObstacleVOs", ProfileCounter::obstacleVOCandidates, ProfileCounter::obstacleVOsBuilt);
+	ImGui::Columns(1);
+	float collections = profiler.getCounterStats(ProfileCounter::voCollections).average;
+	if (collections > 0.0f)
+		ImGui::Text("VOs per boid %.2f", (profiler.getCounterStats(ProfileCounter::actorVOsBuilt).average +
+			profiler.getCounterStats(ProfileCounter::obstacleVOsBuilt).average) / collections);
+
+	//Trace capture of the next few frames for Perfetto / chrome://tracing
+	TraceRecorder& recorder = TraceRecorder::get();
+	ImGui::InputInt("Trace frames", &s_traceFrames);
+	if (recorder.isCapturing())
+		ImGui::Text("Capturing trace...");
+	else if (ImGui::Button("Capture trace"))
+	{
+		recorder.start(s_traceFrames);
+		s_tracePending = true;
+	}
+	if (s_tracePending && !recorder.isCapturing())
+	{
+		s_tracePending = false;
+		if (!recorder.write(s_tracePath))
+			std::cout << "Failed to write " << s_tracePath << std::endl;
+	}
+	if (recorder.hasCapture())
+	{
+		ImGui::SameLine();
+		ImGui::Text("Last capture written to %s", s_tracePath);
+	}
+	ImGui::End();
+}
@@ -0,0 +1,4 @@
+#pragma once
+
+//Draws the per-phase timing window from the Profiler's history
+void drawProfilerPanel();
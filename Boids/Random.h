@@ -0,0 +1,57 @@
+#pragma once
+
+#include <cstdint>
+#include <cmath>
+
+//Small PCG32 generator. Unlike rand() or the std distributions its output 
+//only depends on the seed, so the same seed gives the same flock on every 
+//platform and build
+class Random
+{
+private:
+	uint64_t m_state;
+	uint64_t m_increment;
+	bool m_hasSpare = false;
+	float m_spare = 0.0f;
+public:
+	explicit Random(uint64_t seed, uint64_t stream = 0x14057b7ef767814fULL)
+		: m_state(0), m_increment((stream << 1u) | 1u)
+	{
+		next();
+		m_state += seed;
+		next();
+	}
+
+	uint32_t next()
+	{
+		uint64_t old = m_state;
+		m_state = old * 6364136223846793005ULL + m_increment;
+		uint32_t xorShifted = (uint32_t)(((old >> 18u) ^ old) >> 27u);
+		uint32_t rot = (uint32_t)(old >> 59u);
+		return (xorShifted >> rot) | (xorShifted << ((0u - rot) & 31u));
+	}
+
+	//Uniform in [0, 1)
+	float uniform() { return (next() >> 8) * (1.0f / 16777216.0f); }
+	//Uniform in [min, max)
+	float uniform(float min, float max) { return min + (max - min) * uniform(); }
+	//Uniform in [0, count)
+	int index(int count) { return (int)(((uint64_t)next() * (uint64_t)count) >> 32); }
+
+	//Normally distributed via Box-Muller, caching the second value
+	float gaussian(float mean, float stdDev)
+	{
+		if (m_hasSpare)
+		{
+			m_hasSpare = false;
+			return mean + stdDev * m_spare;
+		}
+		float u = 1.0f - uniform();
+		float v = uniform();
+		float r = std::sqrt(-2.0f * std::log(u));
+		float theta = 6.28318530718f * v;
+		m_spare = r * std::sin(theta);
+		m_hasSpare = true;
+		return mean + stdDev * r * std::cos(theta);
+	}
+};
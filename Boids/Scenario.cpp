@@ -0,0 +1,184 @@
+#include "Scenario.h"
+#include <chrono>
+#include <cstring>
+#include <algorithm>
+#define _USE_MATH_DEFINES
+#include <math.h>
+
+const char* getPatternName(SpawnPattern pattern)
+{
+	switch (pattern)
+	{
+	case SpawnPattern::uniformBox:
+		return "uniform";
+	case SpawnPattern::gaussianClusters:
+		return "clusters";
+	case SpawnPattern::ring:
+		return "ring";
+	case SpawnPattern::denseClump:
+		return "clump";
+	}
+	return "unknown";
+}
+
+bool parsePatternName(const char* name, SpawnPattern& pattern)
+{
+	const SpawnPattern patterns[4] = { SpawnPattern::uniformBox, 
+		SpawnPattern::gaussianClusters, SpawnPattern::ring, SpawnPattern::denseClump };
+	for (SpawnPattern candidate : patterns)
+	{
+		if (std::strcmp(name, getPatternName(candidate)) == 0)
+		{
+			pattern = candidate;
+			return true;
+		}
+	}
+	return false;
+}
+
+ScenarioGenerator::ScenarioGenerator(const Scenario& scenario, int dimensions)
+	: m_scenario(scenario), m_seed(scenario.seed != 0 ? scenario.seed : freshSeed()),
+	m_random(m_seed), m_extent(scenario.extent)
+{
+	//Keep roughly the density of 100 boids in the original 201 unit box
+	if (m_extent <= 0.0f)
+	{
+		float scale = std::fmax(1.0f, scenario.numBoids / 100.0f);
+		m_extent = 100.0f * (dimensions == 3 ? std::cbrt(scale) : std::sqrt(scale));
+	}
+
+	if (m_scenario.pattern == SpawnPattern::gaussianClusters)
+	{
+		int clusters = std::max(1, m_scenario.clusterCount);
+		m_clusterCentres.reserve(clusters);
+		for (int i = 0; i < clusters; i++)
+		{
+			vec3 centre;
+			centre.x = m_random.uniform(-m_extent, m_extent);
+			centre.y = m_random.uniform(-m_extent, m_extent);
+			if (dimensions == 3)
+				centre.z = m_random.uniform(-m_extent, m_extent);
+			m_clusterCentres.push_back(centre);
+		}
+	}
+}
+
+void ScenarioGenerator::nextBoid(vec2& position, vec2& velocity)
+{
+	float speed = m_scenario.startSpeed;
+	velocity = vec2(m_random.uniform(-speed, speed), m_random.uniform(-speed, speed));
+
+	switch (m_scenario.pattern)
+	{
+	case SpawnPattern::uniformBox:
+		position = vec2(m_random.uniform(-m_extent, m_extent), 
+			m_random.uniform(-m_extent, m_extent));
+		break;
+	case SpawnPattern::gaussianClusters:
+	{
+		const vec3& centre = m_clusterCentres[m_boidIndex % m_clusterCentres.size()];
+		position = vec2(m_random.gaussian(centre.x, m_scenario.clusterSpread),
+			m_random.gaussian(centre.y, m_scenario.clusterSpread));
+	}
+		break;
+	case SpawnPattern::ring:
+	{
+		//Evenly spaced on a circle heading for the opposite side, as in the circle test
+		float angle = 2 * M_PI * m_boidIndex / std::max(1, m_scenario.numBoids);
+		position = vec2(cos(angle), sin(angle)) * (m_extent * 0.8f);
+		velocity = vec2() - position.unit();
+	}
+		break;
+	case SpawnPattern::denseClump:
+	{
+		//Uniform over a disc sized to hold the flock at the requested density
+		float radius = std::sqrt(std::max(1, m_scenario.numBoids) / (M_PI * m_scenario.clumpDensity));
+		float r = radius * std::sqrt(m_random.uniform());
+		float angle = m_random.uniform(0.0f, 2 * M_PI);
+		position = vec2(cos(angle) * r, sin(angle) * r);
+	}
+		break;
+	}
+	m_boidIndex++;
+}
+
+void ScenarioGenerator::nextBoid(vec3& position, vec3& velocity)
+{
+	float speed = m_scenario.startSpeed;
+	velocity = vec3(m_random.uniform(-speed, speed), m_random.uniform(-speed, speed),
+		m_random.uniform(-speed, speed));
+
+	switch (m_scenario.pattern)
+	{
+	case SpawnPattern::uniformBox:
+		position = vec3(m_random.uniform(-m_extent, m_extent), 
+			m_random.uniform(-m_extent, m_extent), m_random.uniform(-m_extent, m_extent));
+		break;
+	case SpawnPattern::gaussianClusters:
+	{
+		const vec3& centre = m_clusterCentres[m_boidIndex % m_clusterCentres.size()];
+		position = vec3(m_random.gaussian(centre.x, m_scenario.clusterSpread),
+			m_random.gaussian(centre.y, m_scenario.clusterSpread),
+			m_random.gaussian(centre.z, m_scenario.clusterSpread));
+	}
+		break;
+	case SpawnPattern::ring:
+	{
+		float angle = 2 * M_PI * m_boidIndex / std::max(1, m_scenario.numBoids);
+		position = vec3(cos(angle), sin(angle), 0.0f) * (m_extent * 0.8f);
+		velocity = vec3() - position.unit();
+	}
+		break;
+	case SpawnPattern::denseClump:
+	{
+		//Uniform over a ball sized to hold the flock at the requested density
+		float radius = std::cbrt(3 * std::max(1, m_scenario.numBoids) / (4 * M_PI * m_scenario.clumpDensity));
+		float r = radius * std::cbrt(m_random.uniform());
+		float z = m_random.uniform(-1.0f, 1.0f);
+		float angle = m_random.uniform(0.0f, 2 * M_PI);
+		float planar = std::sqrt(1.0f - z * z);
+		position = vec3(cos(angle) * planar, sin(angle) * planar, z) * r;
+	}
+		break;
+	}
+	m_boidIndex++;
+}
+
+void ScenarioGenerator::nextObstacle(vec2& position)
+{
+	if (m_scenario.pattern == SpawnPattern::ring)
+	{
+		//Inner ring of obstacles between the boids and their destinations
+		float angle = 2 * M_PI * (m_obstacleIndex + 1) / std::max(1, m_scenario.numObstacles);
+		position = vec2(cos(angle), sin(angle)) * (m_extent * 0.4f);
+	}
+	else
+	{
+		position = vec2(m_random.uniform(-m_extent, m_extent), 
+			m_random.uniform(-m_extent, m_extent));
+	}
+	m_obstacleIndex++;
+}
+
+void ScenarioGenerator::nextObstacle(vec3& position)
+{
+	if (m_scenario.pattern == SpawnPattern::ring)
+	{
+		float angle = 2 * M_PI * (m_obstacleIndex + 1) / std::max(1, m_scenario.numObstacles);
+		position = vec3(cos(angle), sin(angle), 0.0f) * (m_extent * 0.4f);
+	}
+	else
+	{
+		position = vec3(m_random.uniform(-m_extent, m_extent), 
+			m_random.uniform(-m_extent, m_extent), m_random.uniform(-m_extent, m_extent));
+	}
+	m_obstacleIndex++;
+}
+
+uint32_t ScenarioGenerator::freshSeed()
+{
+	uint64_t ticks = (uint64_t)std::chrono::high_resolution_clock::now().time_since_epoch().count();
+	Random mixer(ticks);
+	uint32_t seed = mixer.next();
+	return seed != 0 ? seed : 1;
+}
@@ -0,0 +1,71 @@
+#pragma once
+
+#include "vec2.h"
+#include "vec3.h"
+#include "Random.h"
+#include <vector>
+
+enum class SpawnPattern
+{
+	uniformBox,
+	gaussianClusters,
+	ring,
+	denseClump
+};
+
+//Describes the starting layout of a run. Two runs with the same scenario 
+//and a non-zero seed start from identical flocks
+struct Scenario
+{
+	SpawnPattern pattern = SpawnPattern::uniformBox;
+	int numBoids = 100;
+	int numObstacles = 10;
+	float obstacleRadius = 2.0f;
+	//Half width of the spawn region. Zero or less sizes it from numBoids so 
+	//larger flocks keep the density of the original 100 boid box, or cube 
+	//when spawning in 3D
+	float extent = 100.0f;
+	//Starting velocity components are drawn from [-startSpeed, startSpeed]
+	float startSpeed = 3.0f;
+	int clusterCount = 4;
+	//Standard deviation of each gaussian cluster
+	float clusterSpread = 10.0f;
+	//Boids per square unit in the dense clump, per cubic unit in 3D
+	float clumpDensity = 0.5f;
+	//Zero picks a fresh seed, the one used is reported by the generator
+	uint32_t seed = 0;
+};
+
+const char* getPatternName(SpawnPattern pattern);
+bool parsePatternName(const char* name, SpawnPattern& pattern);
+
+//Produces boid and obstacle start states for a scenario one at a time so 
+//millions of entities can be spawned without intermediate storage. The 3D 
+//layouts are volumetric versions of the 2D ones, except the ring which stays 
+//on z = 0
+class ScenarioGenerator
+{
+private:
+	Scenario m_scenario;
+	uint32_t m_seed;
+	Random m_random;
+	float m_extent;
+	int m_boidIndex = 0;
+	int m_obstacleIndex = 0;
+	//Z is only drawn for 3D so 2D runs keep their random sequence
+	std::vector<vec3> m_clusterCentres;
+public:
+	//dimensions is 2 or 3 and picks which overloads below will be called
+	explicit ScenarioGenerator(const Scenario& scenario, int dimensions = 2);
+
+	uint32_t getSeed() const { return m_seed; }
+	float getExtent() const { return m_extent; }
+
+	void nextBoid(vec2& position, vec2& velocity);
+	void nextBoid(vec3& position, vec3& velocity);
+	void nextObstacle(vec2& position);
+	void nextObstacle(vec3& position);
+
+	//Returns a seed for scenarios that don't specify one
+	static uint32_t freshSeed();
+};
@@ -1,17 +1,18 @@
 #include "Shape.h"
+#include <cassert>
 #define _USE_MATH_DEFINES
 #include <math.h>
 
-bool Shape::isPointInside(vec3 point)
+bool Shape::isPointInside(vec2 point) const
 {
 	bool firstSet = true;
 	bool onLeft = false;
-	for (Line& line : m_lines)
+	for (int i = 0; i < m_lineCount; i++)
 	{
-		vec3 relativePoint = point - (line.point + m_position);
-		vec3 lineDir = line.getFacingVec();
-		vec3 perpDir = vec3(-lineDir.y, lineDir.x, 0.0f);
-		float delta = perpDir.unit().dot(relativePoint);
+		const Line& line = m_lines[i];
+		vec2 relativePoint = point - (line.point + m_position);
+		//Distance to the left of the line, as the facing vector is unit length
+		float delta = line.getFacingVec().cross(relativePoint);
 		//For the point to be inside a convex shape it must be on the same side of all 
 		//lines that represent that convex shape
 		if (delta > 0.0f)
@@ -38,99 +39,111 @@ bool Shape::isPointInside(vec3 point)
 	return true;
 }
 
-void Shape::minkowskySum(std::list<Line>& pointsToAdd)
+void Shape::sortLines(Line* lines, int count)
 {
-	m_lines.sort();
-	pointsToAdd.sort();
-	vec3 nextPosition;
-	if (m_lines.size() == 0)
-		nextPosition = pointsToAdd.front().point;
+	for (int i = 1; i < count; i++)
+	{
+		Line line = lines[i];
+		int j = i;
+		for (; j > 0 && line < lines[j - 1]; j--)
+			lines[j] = lines[j - 1];
+		lines[j] = line;
+	}
+}
+
+void Shape::minkowskySum(const Line* linesToAdd, int count)
+{
+	assert(m_lineCount + count <= maxLines);
+	if (count == 0)
+		return;
+	Line added[maxLines];
+	for (int i = 0; i < count; i++)
+		added[i] = linesToAdd[i];
+	sortLines(added, count);
+
+	vec2 nextPosition;
+	if (m_lineCount == 0)
+		nextPosition = added[0].point;
 	else
-		nextPosition = m_lines.front().point + pointsToAdd.front().point;
+		nextPosition = m_lines[0].point + added[0].point;
+
+	//Merge from the back so it can be done in place. On equal angles the 
+	//shape's own edge goes first
+	int own = m_lineCount - 1;
+	int other = count - 1;
+	for (int out = m_lineCount + count - 1; other >= 0; out--)
+	{
+		if (own >= 0 && added[other] < m_lines[own])
+			m_lines[out] = m_lines[own--];
+		else
+			m_lines[out] = added[other--];
+	}
+	m_lineCount += count;
 
-	m_lines.merge(pointsToAdd);
 	//Recalculate points
-	for (Line& line : m_lines)
+	for (int i = 0; i < m_lineCount; i++)
 	{
-		line.point = nextPosition;
-		nextPosition = nextPosition + (line.getFacingVec() * line.length);
+		m_lines[i].point = nextPosition;
+		nextPosition = nextPosition + (m_lines[i].getFacingVec() * m_lines[i].length);
 	}
 }
 
-void Shape::addSquare(vec3 dir, float length)
+void Shape::addSquare(vec2 dir, float length)
 {
 	dir = dir.unit() * length;
-	std::list<vec3> squarePoints;
-	squarePoints.push_back(vec3(dir.x, dir.y, 0.0f));
-	squarePoints.push_back(vec3(dir.y, -dir.x, 0.0f));
-	squarePoints.push_back(vec3(-dir.x, -dir.y, 0.0f));
-	squarePoints.push_back(vec3(-dir.y, dir.x, 0.0f));
-	Shape tempShape = Shape(squarePoints, m_position);
-	minkowskySum(tempShape.m_lines);
+	vec2 squarePoints[4] = { vec2(dir.x, dir.y), vec2(dir.y, -dir.x),
+		vec2(-dir.x, -dir.y), vec2(-dir.y, dir.x) };
+	Shape tempShape = Shape(squarePoints, 4, m_position);
+	minkowskySum(tempShape.m_lines, tempShape.m_lineCount);
 }
 
-void Shape::addConeSection(vec3 relativePos, float selfRadius, float objectRadius, float scaleFactor)
+void Shape::addConeSection(vec2 relativePos, float selfRadius, float objectRadius, float scaleFactor)
 {
 	float dist = relativePos.mag();
 	float combinedRadius = selfRadius + objectRadius;
 	//Create a pi/2 anticlockwise rotated perpendicular
-	vec3 perpDir = vec3(-relativePos.y, relativePos.x, 0.0f);
+	vec2 perpDir = relativePos.perp();
 	//Calculate components of close points on the cone
-	vec3 distComponent = relativePos.unit() * (dist - combinedRadius);
-	vec3 perpComponent = perpDir.unit() * tan(asin(combinedRadius / dist)) * (dist - combinedRadius);
+	vec2 distComponent = relativePos.unit() * (dist - combinedRadius);
+	vec2 perpComponent = perpDir.unit() * tan(asin(combinedRadius / dist)) * (dist - combinedRadius);
 	//Create the set of points for the cone section
-	vec3 closePoint1 = distComponent - perpComponent;
-	vec3 closePoint2 = distComponent + perpComponent;
-	vec3 farPoint1 = closePoint1 * scaleFactor;
-	vec3 farPoint2 = closePoint2 * scaleFactor;
+	vec2 closePoint1 = distComponent - perpComponent;
+	vec2 closePoint2 = distComponent + perpComponent;
+	vec2 farPoint1 = closePoint1 * scaleFactor;
+	vec2 farPoint2 = closePoint2 * scaleFactor;
 	//Create a temporary shape that defines the new cone
-	std::list<vec3> conePoints;
-	conePoints.push_back(closePoint1);
-	conePoints.push_back(farPoint1);
-	conePoints.push_back(farPoint2);
-	conePoints.push_back(closePoint2);
-	Shape tempShape = Shape(conePoints, vec3());
+	vec2 conePoints[4] = { closePoint1, farPoint1, farPoint2, closePoint2 };
+	Shape tempShape = Shape(conePoints, 4, vec2());
 	//Add to existing shape
-	minkowskySum(tempShape.m_lines);
+	minkowskySum(tempShape.m_lines, tempShape.m_lineCount);
 }
 
-Shape::Shape(vec3 position) : m_position(position)
+Shape::Shape(vec2 position) : m_position(position)
 {
 }
 
-Shape::Shape(vec3 position, std::list<Line>& lines) : m_position(position)
+Shape::Shape(vec2 position, const Line* lines, int count) : m_position(position)
 {
-	for (Line line : lines)
-	{
-		m_lines.emplace_back(line);
-	}
-	m_lines.sort();
+	assert(count <= maxLines);
+	for (int i = 0; i < count; i++)
+		m_lines[i] = lines[i];
+	m_lineCount = count;
+	sortLines(m_lines, m_lineCount);
 }
 
-Shape::Shape(std::list<vec3>& points, vec3 position) : m_position(position)
+Shape::Shape(const vec2* points, int pointCount, vec2 position) : m_position(position)
 {
-	vec3 lastPoint = points.back();
-	for (vec3 point : points)
+	assert(pointCount <= maxLines);
+	vec2 lastPoint = points[pointCount - 1];
+	for (int i = 0; i < pointCount; i++)
 	{
+		vec2 point = points[i];
 		//Add the previous point to the shape
-		vec3 diff = (point - lastPoint).unit();
+		vec2 diff = (point - lastPoint).unit();
 		float length = (point - lastPoint).mag();
 		float angle = atan2(diff.y, diff.x);
-		m_lines.emplace_back(Line(lastPoint, angle, length));
+		m_lines[m_lineCount++] = Line(lastPoint, angle, length);
 		lastPoint = point;
 	}
-	m_lines.sort();
-}
-
-vec3 Shape::Line::getFacingVec()
-{
-	return vec3(cos(angle), sin(angle), 0.0f);
-}
-
-bool Shape::Line::operator<(const Line& rhs)
-{
-	if (angle < rhs.angle)
-		return true;
-	else
-		return false;
+	sortLines(m_lines, m_lineCount);
 }
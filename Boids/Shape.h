@@ -1,40 +1,55 @@
 #pragma once
 
-#include "vec3.h"
-#include <list>
+#include "vec2.h"
 
-//Note: only handles convex shapes
+//Note: only handles convex shapes. Edges are kept inline, sorted by angle, 
+//so a shape is one contiguous block that can be copied like a value
 class Shape
 {
 public:
+	//A cone section summed with a square, the most any velocity obstacle needs
+	static const int maxLines = 8;
+
 	struct Line
 	{
-		vec3 point;
+		vec2 point;
 		float angle; //In radians
 		float length;
+		//Unit vector along the angle, worked out once rather than per test
+		vec2 facing;
 
-		Line(vec3 pos, float dir, float dist) : point(pos), angle(dir), length(dist) {}
-		vec3 getFacingVec();
-		bool operator<(const Line& rhs);
+		Line() = default;
+		Line(vec2 pos, float dir, float dist) 
+			: point(pos), angle(dir), length(dist), facing(std::cos(dir), std::sin(dir)) {}
+		vec2 getFacingVec() const { return facing; }
+		bool operator<(const Line& rhs) const { return angle < rhs.angle; }
 	};
 private:
-	vec3 m_position;
-	std::list<Line> m_lines;
+	vec2 m_position;
+	int m_lineCount = 0;
+	Line m_lines[maxLines];
+
+	//Stable insertion sort by angle, the arrays are never longer than maxLines
+	static void sortLines(Line* lines, int count);
 public:
 	//Checks if a point lies inside the collection 
 	//of sorted lines that makes up the shape
-	bool isPointInside(vec3 point);
+	bool isPointInside(vec2 point) const;
 	//Adds two shapes together to get the region 
-	//defined by the area the two would intersect
-	void minkowskySum(std::list<Line>& pointsToAdd);
+	//defined by the area the two would intersect. Together they can't have 
+	//more than maxLines edges
+	void minkowskySum(const Line* linesToAdd, int count);
 	//Creates a square and adds it to the shape via Minkowsky summation
-	void addSquare(vec3 dir, float length);
+	void addSquare(vec2 dir, float length);
 	//Creates a cone and adds it to the shape via Minkowsky summation
-	void addConeSection(vec3 relativePos, float selfRadius, 
+	void addConeSection(vec2 relativePos, float selfRadius, 
 		float objectRadius, float scaleFactor);
 
-	Shape(vec3 position);
-	Shape(vec3 position, std::list<Line>& lines);
-	Shape(std::list<vec3>& points, vec3 position);
-};
+	int getLineCount() const { return m_lineCount; }
+	const Line* getLines() const { return m_lines; }
 
+	Shape(vec2 position);
+	Shape(vec2 position, const Line* lines, int count);
+	//Builds the edges of a polygon from its corners in order
+	Shape(const vec2* points, int pointCount, vec2 position);
+};
@@ -0,0 +1,452 @@
+#include "Simulation.h"
+#include "Boid.h"
+#include "Profiler.h"
+#include <algorithm>
+#define _USE_MATH_DEFINES
+#include <math.h>
+
+template<int D>
+uint32_t BasicSimulation<D>::fillEntities(const Scenario& scenario)
+{
+	ScenarioGenerator generator(scenario, D);
+
+	//Create a set of boids
+	m_boids.reserve(m_boids.size() + scenario.numBoids);
+	for (int i = 0; i < scenario.numBoids; i++)
+	{
+		vec pos, vel;
+		generator.nextBoid(pos, vel);
+		addBoid(pos, vel);
+	}
+
+	//Create a set of obstacles
+	m_obstacles.reserve(m_obstacles.size() + scenario.numObstacles);
+	for (int i = 0; i < scenario.numObstacles; i++)
+	{
+		vec pos;
+		generator.nextObstacle(pos);
+		addObstacle(pos, scenario.obstacleRadius);
+	}
+
+	return generator.getSeed();
+}
+
+template<int D>
+void BasicSimulation<D>::setUpCircle(float obstRadius)
+{
+	float angle = 0.0f;
+	//Align boids to circle
+	//Each profile in use gets a copy that sends its boids right to the destination
+	//Profiles that already do, like the copies an earlier setup made, are reused
+	std::vector<int> circleProfiles(m_boids.profiles.size(), -1);
+	for (int i = 0; i < m_boids.size(); i++)
+	{
+		int& circleProfile = circleProfiles[m_boids.profile[i]];
+		if (circleProfile < 0)
+		{
+			BoidProfile profile = m_boids.getProfile(i);
+			if (profile.homeDist == 1.0f)
+				circleProfile = m_boids.profile[i];
+			else
+			{
+				profile.homeDist = 1.0f;
+				circleProfile = m_boids.addProfile(profile);
+			}
+		}
+		m_boids.profile[i] = (uint16_t)circleProfile;
+	}
+	for (int i = 0; i < m_boids.size(); i++)
+	{
+		vec pos = Dimension<D>::fromPlanar(vec2(cos(angle) * 80.0f, sin(angle) * 80.0f));
+		m_boids.position[i] = pos;
+		m_boids.velocity[i] = vec() - pos.unit();
+		m_boids.homeLocation[i] = vec() - pos;
+		m_partition.haveMoved(i, pos);
+		angle += (2 * M_PI / m_boids.size());
+	}
+	m_flockUniform = false;
+	int numObst = m_obstacles.size();
+	m_obstacles.clear();
+	m_obstacleHandles.clear();
+	//Align obstacles to inner circle
+	for (int i = 0; i < numObst; i++)
+	{
+		angle += (2 * M_PI / numObst);
+		vec position = Dimension<D>::fromPlanar(vec2(cos(angle) * 40.0f, sin(angle) * 40.0f));
+		addObstacle(position, obstRadius);
+	}
+}
+
+template<int D>
+void BasicSimulation<D>::clear()
+{
+	m_partition.clearActors();
+	m_boids.clear();
+	m_obstacles.clear();
+	m_obstacleHandles.clear();
+	m_obstaclesStale = true;
+}
+
+template<int D>
+Handle BasicSimulation<D>::addBoid(vec pos, vec vel)
+{
+	int index = m_boids.add(pos, vel);
+	m_boids.homeLocation[index] = m_appliedHome;
+	m_partition.addActor(index, pos);
+	return m_boids.handles.getHandle(index);
+}
+
+template<int D>
+void BasicSimulation<D>::removeBoidAt(int index)
+{
+	m_partition.removeActor(index);
+	int moved = m_boids.remove(index);
+	if (moved >= 0)
+		m_partition.renameActor(moved, index);
+}
+
+template<int D>
+bool BasicSimulation<D>::removeBoid(Handle boid)
+{
+	int index = m_boids.handles.find(boid);
+	if (index < 0)
+		return false;
+	removeBoidAt(index);
+	return true;
+}
+
+template<int D>
+Handle BasicSimulation<D>::addObstacle(vec pos, float radius)
+{
+	m_obstacles.emplace_back(pos, radius);
+	m_obstaclesStale = true;
+	return m_obstacleHandles.insert();
+}
+
+template<int D>
+void BasicSimulation<D>::removeObstacleAt(int index)
+{
+	int last = (int)m_obstacles.size() - 1;
+	m_obstacles[index] = m_obstacles[last];
+	m_obstacles.pop_back();
+	m_obstacleHandles.erase(index);
+	m_obstaclesStale = true;
+}
+
+template<int D>
+bool BasicSimulation<D>::removeObstacle(Handle obstacle)
+{
+	int index = m_obstacleHandles.find(obstacle);
+	if (index < 0)
+		return false;
+	removeObstacleAt(index);
+	return true;
+}
+
+template<int D>
+int BasicSimulation<D>::removeNear(vec position, float radius)
+{
+	//Gather handles first as removals reshuffle the indices held by the cells
+	std::vector<Handle> boids, obstacles;
+	refreshPartition();
+	refreshObstacles();
+	CellRange<D> range = m_partition.findCellRange(position, radius);
+	m_partition.forEachCell(range, [&](const auto& cell)
+	{
+		for (int boid : cell.actors)
+		{
+			if ((m_boids.position[boid] - position).mag() <= radius)
+				boids.push_back(m_boids.handles.getHandle(boid));
+		}
+	});
+	m_obstacleIndex.query(position, radius, [&](const auto& entry)
+	{
+		if ((entry.position - position).mag() <= radius)
+			obstacles.push_back(m_obstacleHandles.getHandle(entry.obstacle));
+	});
+
+	for (Handle boid : boids)
+		removeBoid(boid);
+	for (Handle obstacle : obstacles)
+		removeObstacle(obstacle);
+	return (int)(boids.size() + obstacles.size());
+}
+
+BoidProfile ActorSettings::toProfile() const
+{
+	BoidProfile profile;
+	profile.maxAcceleration = maxAcceleration;
+	profile.maxSpeed = speed;
+	profile.homeDist = homeDist;
+	profile.viewArc = viewArc;
+	profile.radius = radius;
+	profile.avoidanceDist = avoidanceDist;
+	profile.detectionDist = detectionDist;
+	profile.useFlocking = useFlocking;
+	profile.useClearPath = useClearPath;
+	return profile;
+}
+
+template<int D>
+void BasicSimulation<D>::applySettings(const ActorSettings& settings)
+{
+	m_boids.setProfile(0, settings.toProfile());
+	vec home = Dimension<D>::fromPlanar(settings.homeLocation);
+	if (m_flockUniform && home == m_appliedHome)
+		return;
+
+	for (int i = 0; i < m_boids.size(); i++)
+	{
+		m_boids.homeLocation[i] = home;
+		m_boids.profile[i] = 0;
+	}
+	m_boids.profiles.resize(1);
+	m_appliedHome = home;
+	m_flockUniform = true;
+}
+
+template<int D>
+void BasicSimulation<D>::applySettings(Handle boid, const ActorSettings& settings)
+{
+	//Leaves the rest of the flock, and any circle test it is running, alone
+	m_boids.setProfile(0, settings.toProfile());
+	int index = m_boids.handles.find(boid);
+	if (index < 0)
+		return;
+	m_boids.profile[index] = 0;
+	m_boids.homeLocation[index] = Dimension<D>::fromPlanar(settings.homeLocation);
+}
+
+template<int D>
+void BasicSimulation<D>::setObstacleRadius(float radius)
+{
+	//Called every frame by the app, so only a real change costs a rebuild
+	for (BasicObstacle<D>& obst : m_obstacles)
+	{
+		if (obst.m_radius == radius)
+			continue;
+		obst.m_radius = radius;
+		m_obstaclesStale = true;
+	}
+}
+
+template<int D>
+void BasicSimulation<D>::setThreadCount(int threadCount)
+{
+	if (threadCount == getThreadCount())
+		return;
+	if (threadCount > 1)
+		m_workers.reset(new WorkerPool(threadCount));
+	else
+		m_workers.reset();
+	m_arenas.resize(getThreadCount());
+}
+
+template<int D>
+void BasicSimulation<D>::steering()
+{
+	PROFILE_SCOPE(ProfilePhase::steering);
+	for (FrameArena& arena : m_arenas)
+		arena.reset();
+	//Quantising reads the partition's width afresh every frame, so a new 
+	//width is picked up whenever the partition switches to it
+	if (m_autoCellWidth)
+		tuneCellWidth();
+
+	const CompactBoidStore* compact = nullptr;
+	if constexpr (D == 2)
+	{
+		if (m_compactState)
+		{
+			PROFILE_SCOPE(ProfilePhase::quantize);
+			if (m_compact.quantize(m_boids, m_partition))
+				compact = &m_compact;
+		}
+	}
+	//Catches boids spawned or removed since the last frame, and any the 
+	//quantisation nudged over a cell edge
+	refreshPartition();
+	refreshIndex();
+	refreshObstacles();
+
+	//Chosen once per frame so each steering loop is compiled for one index
+	switch (m_indexType)
+	{
+	case SpatialIndexType::kdTree:
+		steerWith(m_kdTree, compact);
+		break;
+	case SpatialIndexType::bvh:
+		steerWith(m_aabbTree, compact);
+		break;
+	default:
+		steerWith(GridIndex<D>(m_partition), compact);
+		break;
+	}
+}
+
+template<int D>
+template<typename Index>
+void BasicSimulation<D>::steerWith(const Index& index, const CompactBoidStore* compact)
+{
+	if (!m_workers)
+	{
+		Boid::steering<D>(m_boids, 0, m_boids.size(), m_obstacleIndex, index, m_arenas[0], compact);
+		return;
+	}
+
+	m_workers->parallelFor(m_boids.size(), [this, &index, compact](int begin, int end, int thread)
+	{
+		Boid::steering<D>(m_boids, begin, end, m_obstacleIndex, index, m_arenas[thread], compact);
+	});
+}
+
+template<int D>
+void BasicSimulation<D>::setSpatialIndex(SpatialIndexType type)
+{
+	if (type == m_indexType)
+		return;
+	m_indexType = type;
+	//Frees whichever tree was in use, and starts a BVH afresh
+	m_kdTree = BasicKdTree<D>();
+	m_aabbTree = BasicAabbTree<D>();
+}
+
+template<int D>
+void BasicSimulation<D>::refreshIndex()
+{
+	if (m_indexType == SpatialIndexType::grid)
+		return;
+	//The trees don't know which boids have changed, so they look at them 
+	//all. The kd-tree rebuilds, while the BVH only refiles boids that have 
+	//left their leaves, including any whose index now belongs to another boid
+	PROFILE_SCOPE(ProfilePhase::indexUpdate);
+	if (m_indexType == SpatialIndexType::kdTree)
+		m_kdTree.update(m_boids.position);
+	else
+		m_aabbTree.update(m_boids.position);
+}
+
+template<int D>
+void BasicSimulation<D>::setPartitionWidth(float width)
+{
+	if (width == m_partition.getPendingWidth())
+		return;
+	m_partition.setPartitionWidth(width);
+}
+
+template<int D>
+void BasicSimulation<D>::setAutoCellWidth(bool autoWidth)
+{
+	m_autoCellWidth = autoWidth;
+	m_widthTuner.restart();
+}
+
+template<int D>
+void BasicSimulation<D>::tuneCellWidth()
+{
+	//Samples read the current cells, so a change has to finish first
+	if (m_partition.isMigrating())
+		return;
+	PROFILE_SCOPE(ProfilePhase::cellWidthTuning);
+	//Samples read the cells, so a sorted partition has to be current
+	refreshPartition();
+	setPartitionWidth(m_widthTuner.update(m_boids, m_partition));
+}
+
+template<int D>
+void BasicSimulation<D>::refreshObstacles()
+{
+	if (!m_obstaclesStale)
+		return;
+	PROFILE_SCOPE(ProfilePhase::obstacleIndex);
+	m_obstacleIndex.build(m_obstacles, m_partition.getPartitionWidth());
+	m_obstaclesStale = false;
+}
+
+template<int D>
+const BasicObstacleIndex<D>& BasicSimulation<D>::getObstacleIndex()
+{
+	refreshObstacles();
+	return m_obstacleIndex;
+}
+
+template<int D>
+void BasicSimulation<D>::locomotion(float deltaT)
+{
+	PROFILE_SCOPE(ProfilePhase::locomotion);
+	Boid::locomotion<D>(m_boids, deltaT, m_partition);
+
+	if (m_reorderInterval > 0 && ++m_framesSinceReorder >= m_reorderInterval)
+		reorderBoids();
+	//An eighth of the flock a frame, so a new width takes over within a 
+	//few frames without a pause while every boid is refiled
+	if (m_partition.isMigrating())
+	{
+		PROFILE_SCOPE(ProfilePhase::partitionRebuild);
+		m_partition.migrateActors(m_boids.position, m_boids.size() / 8 + 1);
+	}
+	refreshPartition();
+}
+
+template<int D>
+void BasicSimulation<D>::refreshPartition()
+{
+	//Keeps the cell table in proportion to the flock wherever it goes. The 
+	//table has to double past the flock between prunes, so the refile is 
+	//paid for by the cells added since the last one
+	if (m_partition.hasExcessCells())
+	{
+		PROFILE_SCOPE(ProfilePhase::partitionRebuild);
+		m_partition.pruneCells(m_boids.position);
+	}
+	if (!m_partition.needsRebuild())
+		return;
+	PROFILE_SCOPE(ProfilePhase::partitionRebuild);
+	m_partition.rebuildActors(m_boids.position);
+}
+
+template<int D>
+void BasicSimulation<D>::reorderBoids()
+{
+	PROFILE_SCOPE(ProfilePhase::reorder);
+	m_framesSinceReorder = 0;
+	int count = m_boids.size();
+
+	//Boids sharing a cell keep their relative order, so a flock that hasn't 
+	//changed cells since the last sort is left alone
+	m_sortKeys.resize(count);
+	for (int i = 0; i < count; i++)
+		m_sortKeys[i] = ((uint64_t)m_partition.getMortonCode(m_boids.position[i]) << 32) | (uint32_t)i;
+	std::sort(m_sortKeys.begin(), m_sortKeys.end());
+
+	m_order.resize(count);
+	m_newIndex.resize(count);
+	bool moved = false;
+	for (int i = 0; i < count; i++)
+	{
+		m_order[i] = (int)(uint32_t)m_sortKeys[i];
+		m_newIndex[m_order[i]] = i;
+		moved |= m_order[i] != i;
+	}
+	if (!moved)
+		return;
+
+	m_boids.permute(m_order, m_permuteScratch);
+	m_partition.remapActors(m_newIndex);
+}
+
+template<int D>
+void BasicSimulation<D>::step(float deltaT)
+{
+	steering();
+	locomotion(deltaT);
+}
+
+template<int D>
+BasicSimulation<D>::BasicSimulation(float partitionWidth)
+	: m_partition(partitionWidth), m_arenas(1)
+{
+}
+
+template class BasicSimulation<2>;
+template class BasicSimulation<3>;
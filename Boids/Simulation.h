@@ -0,0 +1,194 @@
+#pragma once
+
+#include "Dimension.h"
+#include "BoidStore.h"
+#include "Obstacle.h"
+#include "SpacePartition.h"
+#include "SpatialIndex.h"
+#include "KdTree.h"
+#include "AabbTree.h"
+#include "ObstacleIndex.h"
+#include "CellWidthTuner.h"
+#include "SlotMap.h"
+#include "Scenario.h"
+#include "WorkerPool.h"
+#include "FrameArena.h"
+#include "CompactBoidStore.h"
+#include <vector>
+#include <memory>
+
+//Steering parameters applied to every actor in the simulation
+struct ActorSettings
+{
+	float maxAcceleration = 0.1f;
+	float speed = 1.0f;
+	float homeDist = 60.0f;
+	float viewArc = 0.5f;
+	float radius = 2.0f;
+	float avoidanceDist = 20.0f;
+	float detectionDist = 11.0f;
+	bool useFlocking = true;
+	//Ignored by the 3D simulation
+	bool useClearPath = false;
+	//Placed on z = 0 in 3D
+	vec2 homeLocation;
+
+	BoidProfile toProfile() const;
+};
+
+//Owns the partition and every entity in the world. Contains no rendering 
+//so it can be stepped headless. Simulation is the 2D build and Simulation3D 
+//flocks in a volume, the choice of which is made once at compile time
+template<int D>
+class BasicSimulation
+{
+public:
+	using vec = VecN<D>;
+private:
+	BasicSpacePartition<D> m_partition;
+	BasicBoidStore<D> m_boids;
+	std::vector<BasicObstacle<D>> m_obstacles;
+	SlotMap m_obstacleHandles;
+	//Built from m_obstacles with the partition's cell width. Set stale 
+	//whenever an obstacle is added, removed or resized, and built again 
+	//before it is next read
+	BasicObstacleIndex<D> m_obstacleIndex;
+	bool m_obstaclesStale = false;
+	std::unique_ptr<WorkerPool> m_workers;
+	//Scratch memory for steering, one per thread and reset every frame
+	std::vector<FrameArena> m_arenas;
+	//Destination last written to every boid by applySettings
+	vec m_appliedHome;
+	//Cleared once boids are given their own destinations or profiles, so 
+	//the next applySettings has to write out to every boid again
+	bool m_flockUniform = true;
+	//Frames between sorting the boids by cell, 0 to leave them in spawn order
+	int m_reorderInterval = 32;
+	int m_framesSinceReorder = 0;
+	//Kept between reorders to avoid reallocating them
+	std::vector<uint64_t> m_sortKeys;
+	std::vector<int> m_order;
+	std::vector<int> m_newIndex;
+	typename BasicBoidStore<D>::PermuteScratch m_permuteScratch;
+	//Quantised copy of the boids that steering reads neighbours from. Only 
+	//the 2D build packs its state
+	bool m_compactState = false;
+	CompactBoidStore m_compact;
+	//Steering finds neighbours through this, the trees being brought up to 
+	//date with the boids at the start of each steering pass. Only the one 
+	//in use holds anything
+	SpatialIndexType m_indexType = SpatialIndexType::grid;
+	BasicKdTree<D> m_kdTree;
+	BasicAabbTree<D> m_aabbTree;
+	//Picks the partition's cell width when automatic widths are on
+	bool m_autoCellWidth = false;
+	BasicCellWidthTuner<D> m_widthTuner;
+
+	void removeBoidAt(int index);
+	void removeObstacleAt(int index);
+	//Rebuilds a sorted partition if boids have moved, been added or been 
+	//removed since it was last built, and prunes the cells the flock has left
+	void refreshPartition();
+	void refreshIndex();
+	void refreshObstacles();
+	//Lets the tuner sample the boids' queries and starts moving the 
+	//partition to another width if it picks one
+	void tuneCellWidth();
+	//Steers every boid, finding neighbours through the given index
+	template<typename Index>
+	void steerWith(const Index& index, const CompactBoidStore* compact);
+public:
+	//Adds the boids and obstacles described by a scenario. Returns the seed 
+	//used so the run can be reproduced
+	uint32_t fillEntities(const Scenario& scenario);
+	//Moves the existing boids onto a circle heading for the opposite side 
+	//and replaces the obstacles with an inner ring. Both lie on z = 0 in 3D
+	void setUpCircle(float obstRadius);
+	void clear();
+
+	//Boids and obstacles can be added and removed at any time without 
+	//invalidating the handles of the others. Removing through a stale 
+	//handle does nothing and returns false
+	Handle addBoid(vec pos, vec vel);
+	bool removeBoid(Handle boid);
+	Handle addObstacle(vec pos, float radius);
+	bool removeObstacle(Handle obstacle);
+	//Removes every boid and obstacle centred within radius of a point and 
+	//returns how many went
+	int removeNear(vec position, float radius);
+
+	//Current index into getBoids() or getObstacles(), or -1 if removed
+	int findBoid(Handle boid) const { return m_boids.handles.find(boid); }
+	int findObstacle(Handle obstacle) const { return m_obstacleHandles.find(obstacle); }
+
+	//Copies the settings into the default profile, which every boid uses 
+	//unless given another. The destination is per boid, so it is only 
+	//written out to the flock when it changes or after a circle test
+	void applySettings(const ActorSettings& settings);
+	//Copies the settings into the default profile and gives one boid that 
+	//profile and the settings' destination. The rest of the flock is untouched
+	void applySettings(Handle boid, const ActorSettings& settings);
+	void setObstacleRadius(float radius);
+
+	//Steering only reads other boids so it is split across this many threads
+	void setThreadCount(int threadCount);
+	int getThreadCount() const { return m_workers ? m_workers->getThreadCount() : 1; }
+
+	//Calculates the acceleration of every boid from the current state
+	void steering();
+	//Moves every boid and updates the partition, reordering the boids if 
+	//the reorder interval has passed
+	void locomotion(float deltaT);
+	//Runs a full frame of steering followed by locomotion
+	void step(float deltaT);
+
+	//Sorts the boids into the Morton order of their partition cells, so 
+	//boids near each other in space are near each other in memory and 
+	//neighbour searches read mostly sequentially. Handles are unaffected, 
+	//indices are not
+	void reorderBoids();
+	void setReorderInterval(int frames) { m_reorderInterval = frames; }
+	int getReorderInterval() const { return m_reorderInterval; }
+
+	//Quantises every boid's position and velocity at the start of each 
+	//steering pass and reads neighbours from the packed copy. For the 
+	//benchmarks, which compare it against full float state. Frames where a 
+	//boid is too far out to pack steer from the float arrays. Ignored in 3D
+	void setCompactState(bool compact) { m_compactState = compact; }
+	bool getCompactState() const { return D == 2 && m_compactState; }
+
+	//Linked partitions refile boids one at a time as they cross cells. 
+	//Sorted ones skip that and counting sort every boid into its cell once 
+	//a frame instead, so neighbour searches walk contiguous indices
+	void setPartitionMode(PartitionMode mode) { m_partition.setMode(mode, m_boids.position); }
+	PartitionMode getPartitionMode() const { return m_partition.getMode(); }
+
+	//The grid is the partition itself. The trees cope better with tight 
+	//clusters, which crowd a few cells, at the cost of refreshing them 
+	//every frame. Obstacles are always found through the obstacle index
+	void setSpatialIndex(SpatialIndexType type);
+	SpatialIndexType getSpatialIndex() const { return m_indexType; }
+
+	//Moves the partition to cells of the new width, spread over the next 
+	//few frames in linked mode. The obstacle index keeps its own cells and 
+	//is left as it is
+	void setPartitionWidth(float width);
+	//Retunes the cell width at the start of steering every so often, as 
+	//query radii change or the flock gathers and spreads. Off by default 
+	//so runs at a given width are reproducible
+	void setAutoCellWidth(bool autoWidth);
+	bool getAutoCellWidth() const { return m_autoCellWidth; }
+	BasicCellWidthTuner<D>& getCellWidthTuner() { return m_widthTuner; }
+	const BasicCellWidthTuner<D>& getCellWidthTuner() const { return m_widthTuner; }
+
+	BasicBoidStore<D>& getBoids() { return m_boids; }
+	const BasicBoidStore<D>& getBoids() const { return m_boids; }
+	const std::vector<BasicObstacle<D>>& getObstacles() const { return m_obstacles; }
+	//Brought up to date with the obstacles first
+	const BasicObstacleIndex<D>& getObstacleIndex();
+	BasicSpacePartition<D>& getPartition() { return m_partition; }
+	const BasicSpacePartition<D>& getPartition() const { return m_partition; }
+
+	//The partition has no bounds, only a cell width
+	BasicSimulation(float partitionWidth);
+};
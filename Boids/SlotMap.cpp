@@ -0,0 +1,88 @@
+#include "SlotMap.h"
+#include <utility>
+
+Handle SlotMap::insert()
+{
+	uint32_t slot;
+	if (m_freeHead != Handle::invalidSlot)
+	{
+		slot = m_freeHead;
+		m_freeHead = m_slots[slot].index;
+	}
+	else
+	{
+		slot = (uint32_t)m_slots.size();
+		m_slots.push_back({ 0, 0 });
+	}
+	m_slots[slot].index = (uint32_t)m_denseToSlot.size();
+	m_denseToSlot.push_back(slot);
+
+	Handle handle;
+	handle.slot = slot;
+	handle.generation = m_slots[slot].generation;
+	return handle;
+}
+
+void SlotMap::erase(int index)
+{
+	uint32_t slot = m_denseToSlot[index];
+	uint32_t lastSlot = m_denseToSlot.back();
+
+	//Move the last element into the gap
+	m_denseToSlot[index] = lastSlot;
+	m_slots[lastSlot].index = (uint32_t)index;
+	m_denseToSlot.pop_back();
+
+	m_slots[slot].generation++;
+	m_slots[slot].index = m_freeHead;
+	m_freeHead = slot;
+}
+
+int SlotMap::find(Handle handle) const
+{
+	if (handle.slot >= m_slots.size())
+		return -1;
+	const Slot& slot = m_slots[handle.slot];
+	if (slot.generation != handle.generation || slot.index >= m_denseToSlot.size() ||
+		m_denseToSlot[slot.index] != handle.slot)
+		return -1;
+	return (int)slot.index;
+}
+
+Handle SlotMap::getHandle(int index) const
+{
+	Handle handle;
+	handle.slot = m_denseToSlot[index];
+	handle.generation = m_slots[handle.slot].generation;
+	return handle;
+}
+
+void SlotMap::swap(int a, int b)
+{
+	std::swap(m_denseToSlot[a], m_denseToSlot[b]);
+	m_slots[m_denseToSlot[a]].index = (uint32_t)a;
+	m_slots[m_denseToSlot[b]].index = (uint32_t)b;
+}
+
+void SlotMap::permute(const std::vector<int>& order, std::vector<uint32_t>& scratch)
+{
+	scratch.resize(order.size());
+	for (int i = 0; i < (int)order.size(); i++)
+	{
+		scratch[i] = m_denseToSlot[order[i]];
+		m_slots[scratch[i]].index = (uint32_t)i;
+	}
+	m_denseToSlot.swap(scratch);
+}
+
+void SlotMap::reserve(int count)
+{
+	m_slots.reserve(count);
+	m_denseToSlot.reserve(count);
+}
+
+void SlotMap::clear()
+{
+	for (int i = size() - 1; i >= 0; i--)
+		erase(i);
+}
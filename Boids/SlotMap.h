@@ -0,0 +1,58 @@
+#pragma once
+
+#include <vector>
+#include <cstdint>
+
+//Refers to an entity for as long as it exists, however many others are 
+//added or removed around it. Once the entity is removed the generation no 
+//longer matches and lookups fail rather than finding whatever took its place
+struct Handle
+{
+	uint32_t slot = invalidSlot;
+	uint32_t generation = 0;
+
+	static const uint32_t invalidSlot = 0xffffffffu;
+
+	bool isNull() const { return slot == invalidSlot; }
+	bool operator==(const Handle& rhs) const { return slot == rhs.slot && generation == rhs.generation; }
+	bool operator!=(const Handle& rhs) const { return !(*this == rhs); }
+};
+
+//Maps handles to positions in a densely packed array kept by the owner. 
+//The map only tracks indices, so it works for both SoA and AoS storage: 
+//inserts append at size() - 1 and removals move the last element into the 
+//gap, which the owner mirrors in its own arrays
+class SlotMap
+{
+private:
+	struct Slot
+	{
+		//Dense index while in use, next free slot while free
+		uint32_t index;
+		uint32_t generation;
+	};
+
+	std::vector<Slot> m_slots;
+	std::vector<uint32_t> m_denseToSlot;
+	uint32_t m_freeHead = Handle::invalidSlot;
+public:
+	int size() const { return (int)m_denseToSlot.size(); }
+
+	//Hands out a handle for a new element at dense index size() - 1
+	Handle insert();
+	//Frees the handle of the element at a dense index. The last element 
+	//takes its place, so the owner should move its data the same way
+	void erase(int index);
+	//Dense index of a handle, or -1 if it has been removed
+	int find(Handle handle) const;
+	Handle getHandle(int index) const;
+	//Exchanges two dense positions, keeping both handles pointing at their elements
+	void swap(int a, int b);
+	//Moves the element at dense position order[i] to i for every i, keeping 
+	//every handle pointing at its element. The old order is left in scratch 
+	//so its memory can be reused next time
+	void permute(const std::vector<int>& order, std::vector<uint32_t>& scratch);
+	void reserve(int count);
+	//Frees every handle. Old handles stay invalid after slots are reused
+	void clear();
+};
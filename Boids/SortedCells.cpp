@@ -0,0 +1,37 @@
+#include "SortedCells.h"
+
+#include <algorithm>
+
+void SortedCells::setCellCount(int count)
+{
+	if (count < getCellCount())
+	{
+		m_start.assign(count + 1, 0);
+		m_entities.clear();
+		return;
+	}
+	//New cells go on the end, empty
+	int filed = m_start.empty() ? 0 : m_start.back();
+	m_start.resize(count + 1, filed);
+}
+
+void SortedCells::build(const std::vector<int>& cellOf)
+{
+	int cells = getCellCount();
+	std::fill(m_start.begin(), m_start.end(), 0);
+	for (int cell : cellOf)
+		m_start[cell + 1]++;
+	for (int cell = 0; cell < cells; cell++)
+		m_start[cell + 1] += m_start[cell];
+
+	m_fill.assign(m_start.begin(), m_start.end() - 1);
+	m_entities.resize(cellOf.size());
+	for (int i = 0; i < (int)cellOf.size(); i++)
+		m_entities[m_fill[cellOf[i]]++] = i;
+}
+
+void SortedCells::clear()
+{
+	std::fill(m_start.begin(), m_start.end(), 0);
+	m_entities.clear();
+}
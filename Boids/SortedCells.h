@@ -0,0 +1,50 @@
+#pragma once
+
+#include <vector>
+
+//Read only walk over the entities filed in one cell, stored back to back. 
+//Views into SortedCells, so only valid until it is next built
+class CellSpan
+{
+private:
+	const int* m_begin;
+	const int* m_end;
+public:
+	CellSpan(const int* begin, const int* end) : m_begin(begin), m_end(end) {}
+
+	const int* begin() const { return m_begin; }
+	const int* end() const { return m_end; }
+	int size() const { return (int)(m_end - m_begin); }
+	bool empty() const { return m_begin == m_end; }
+};
+
+//Files entities into cells all at once with a counting sort: count each 
+//cell, prefix sum the counts into offsets, then scatter the entities into 
+//one flat array. Nothing can be moved afterwards, the whole thing is built 
+//again instead, but each cell is a contiguous run of indices
+class SortedCells
+{
+private:
+	//Cell c holds m_entities[m_start[c]] up to m_entities[m_start[c + 1]], 
+	//so it holds a single 0 while there are no cells
+	std::vector<int> m_start = { 0 };
+	std::vector<int> m_entities;
+	//Kept between builds to avoid reallocating it
+	std::vector<int> m_fill;
+public:
+	//New cells start empty. Dropping cells unfiles everything
+	void setCellCount(int count);
+	int getCellCount() const { return (int)m_start.size() - 1; }
+
+	//Files entity i into cell cellOf[i], in index order within each cell
+	void build(const std::vector<int>& cellOf);
+	//Unfiles everything, keeping the cells
+	void clear();
+
+	int getCount(int cell) const { return m_start[cell + 1] - m_start[cell]; }
+	CellSpan getList(int cell) const
+	{
+		const int* entities = m_entities.data();
+		return CellSpan(entities + m_start[cell], entities + m_start[cell + 1]);
+	}
+};
@@ -1,153 +1,409 @@
 #include "SpacePartition.h"
-#include "Boid.h"
-#include "Obstacle.h"
+#include "Profiler.h"
 
 #include <cmath>
 #include <algorithm>
+#include <cassert>
 
+//Written so a NaN width also ends up at the minimum
+static float clampWidth(float width, float minWidth)
+{
+	assert(width > 0.0f);
+	return width > minWidth ? width : minWidth;
+}
 
-bool SpacePartition::isOutOfBounds(int x, int y) const
+template<int D>
+CellHash::Key BasicSpacePartition<D>::getCellKey(vec position, float width) const
 {
-	if (x >= 0 &&
-		y >= 0 &&
-		x < m_sizeX &&
-		y < m_sizeY)
-		return false;
-	else
-		return true;
+	int coords[3] = { 0, 0, 0 };
+	for (int axis = 0; axis < D; axis++)
+	{
+		float cell = std::floor(position[axis] / width);
+		//Kept inside int range before CellHash clamps it further
+		cell = std::min(std::max(cell, (float)-CellHash::coordLimit), (float)CellHash::coordLimit);
+		coords[axis] = (int)cell;
+	}
+	return CellHash::makeKey(coords[0], coords[1], coords[2]);
 }
 
-bool SpacePartition::isOutOfBounds(vec3 position) const
+template<int D>
+int BasicSpacePartition<D>::getOrAddCell(vec position)
 {
-	if (position.x >= m_bottomLeft.x && 
-		position.y >= m_bottomLeft.y &&
-		position.x < m_topRight.x &&
-		position.y < m_topRight.y)
-		return false;
-	else
-		return true;
+	int cell = m_cells.insert(getCellKey(position));
+	if (cell >= m_actors.getCellCount())
+	{
+		m_actors.setCellCount(m_cells.size());
+		m_sortedActors.setCellCount(m_cells.size());
+	}
+	return cell;
+}
+
+template<int D>
+void BasicSpacePartition<D>::releaseCells()
+{
+	if (m_storedObjects > 0)
+		return;
+	m_cells.clear();
+	m_actors.setCellCount(0);
+	m_sortedActors.setCellCount(0);
+}
+
+template<int D>
+void BasicSpacePartition<D>::resetCells()
+{
+	m_actors.clear();
+	m_actors.setCellCount(0);
+	m_sortedActors.setCellCount(0);
+	m_cells.clear();
 }
 
-const SpacePartition::Cell& SpacePartition::getCell(int x, int y) const
+template<int D>
+void BasicSpacePartition<D>::fileAtPendingWidth(int boid, vec position)
 {
-	if (isOutOfBounds(x, y))
-		return m_oob;
+	CellHash::Key key = getCellKey(position, m_pendingWidth);
+	int oldCell = m_pendingActors.getCell(boid);
+	if (oldCell >= 0 && m_pendingCells.getKey(oldCell) == key)
+		return;
+
+	int cell = m_pendingCells.insert(key);
+	if (cell >= m_pendingActors.getCellCount())
+		m_pendingActors.setCellCount(m_pendingCells.size());
+	if (oldCell >= 0)
+		m_pendingActors.move(boid, cell);
 	else
-		return m_partitions[x + (y * m_sizeX)];
+		m_pendingActors.insert(boid, cell);
 }
 
-SpacePartition::Cell& SpacePartition::getCell(vec3 position)
+template<int D>
+void BasicSpacePartition<D>::applyPendingWidth()
 {
-	if (isOutOfBounds(position))
-		return m_oob;
+	if (!isMigrating())
+		return;
+	m_partitionWidth = m_pendingWidth;
+	m_pendingCells.clear();
+	m_pendingActors.clear();
+	m_pendingActors.setCellCount(0);
+	m_migrateCursor = 0;
+	//Every key changes, so the cells are numbered afresh
+	resetCells();
+}
+
+template<int D>
+int BasicSpacePartition<D>::getActorCount(int index) const
+{
+	if (m_mode == PartitionMode::sorted)
+		return m_sortedActors.getCount(index);
 	else
-	{
-		vec3 unrounded = (position - m_bottomLeft) / m_partitionWidth;
-		int cellX = std::floor(unrounded.x);
-		int cellY = std::floor(unrounded.y);
-		return m_partitions[cellX + (cellY * m_sizeX)];
-	}
+		return m_actors.getCount(index);
 }
 
-CellRange SpacePartition::findCellRange(vec3 position, float radius) const
+template<int D>
+int BasicSpacePartition<D>::getActorCount(int x, int y, int z) const
 {
-	bool oob = false;
-	//Fit to ints
-	int blX = std::floor((position.x - radius - m_bottomLeft.x) / m_partitionWidth);
-	int blY = std::floor((position.y - radius - m_bottomLeft.y) / m_partitionWidth);
-	int trX = std::floor((position.x + radius - m_bottomLeft.x) / m_partitionWidth);
-	int trY = std::floor((position.y + radius - m_bottomLeft.y) / m_partitionWidth);
-	
-	//Concatenate OOB regions
-	if (blX < 0 || blY < 0)
-	{
-		oob = true;
-		blX = std::max(blX, 0);
-		blY = std::max(blY, 0);
-	}
-	if (trX >= m_sizeX || trY >= m_sizeY)
+	int cell = m_cells.find(CellHash::makeKey(x, y, z));
+	return cell >= 0 ? getActorCount(cell) : 0;
+}
+
+template<int D>
+CellRange<D> BasicSpacePartition<D>::findCellRange(vec position, float radius) const
+{
+	vec extent = Dimension<D>::splat(radius);
+	return findCellRange(position - extent, position + extent);
+}
+
+template<int D>
+CellRange<D> BasicSpacePartition<D>::findCellRange(vec lo, vec hi) const
+{
+	Range range = makeCellRange<D>(lo, hi, m_partitionWidth);
+	int cells = 1;
+	for (int axis = 0; axis < D; axis++)
+		cells *= range.tr[axis] - range.bl[axis];
+
+	PROFILE_COUNT(ProfileCounter::partitionQueries, 1);
+	PROFILE_COUNT(ProfileCounter::cellsVisited, cells);
+
+	return range;
+}
+
+template<int D>
+CellRange<D> makeCellRange(VecN<D> lo, VecN<D> hi, float cellWidth)
+{
+	CellRange<D> range;
+	for (int axis = 0; axis < D; axis++)
 	{
-		oob = true;
-		trX = std::min(trX, m_sizeX);
-		trY = std::min(trY, m_sizeY);
+		//Fit to ints
+		float bl = std::floor(lo[axis] / cellWidth);
+		//Top right is exclusive, so step past the cell containing the edge
+		float tr = std::floor(hi[axis] / cellWidth) + 1;
+
+		//Clamped as the keys are, so a query far out still finds the edge cells
+		range.bl[axis] = (int)std::min(std::max(bl, (float)-CellHash::coordLimit), (float)CellHash::coordLimit);
+		range.tr[axis] = (int)std::min(std::max(tr, (float)-CellHash::coordLimit + 1), (float)CellHash::coordLimit + 1);
+
+		//Catch inversions
+		range.tr[axis] = std::max(range.tr[axis], range.bl[axis]);
 	}
+	return range;
+}
 
-	//Catch inversions
-	blX = std::min(blX, trX);
-	blY = std::min(blY, trY);
-	trX = std::max(trX, blX);
-	trY = std::max(trY, blY);
+//Spaces out the low 16 bits of a value with a zero between each
+static uint32_t spreadBits2(uint32_t value)
+{
+	value &= 0x0000ffff;
+	value = (value | (value << 8)) & 0x00ff00ff;
+	value = (value | (value << 4)) & 0x0f0f0f0f;
+	value = (value | (value << 2)) & 0x33333333;
+	value = (value | (value << 1)) & 0x55555555;
+	return value;
+}
 
-	return CellRange(blX, blY, trX, trY, oob);
+//Spaces out the low 10 bits of a value with two zeros between each
+static uint32_t spreadBits3(uint32_t value)
+{
+	value &= 0x000003ff;
+	value = (value | (value << 16)) & 0x030000ff;
+	value = (value | (value << 8)) & 0x0300f00f;
+	value = (value | (value << 4)) & 0x030c30c3;
+	value = (value | (value << 2)) & 0x09249249;
+	return value;
 }
 
-void SpacePartition::addActor(const Boid* boid)
+template<int D>
+uint32_t BasicSpacePartition<D>::getMortonCode(vec position) const
 {
-	if (!boid)
-		return;
+	int coords[3];
+	CellHash::splitKey(getCellKey(position), coords[0], coords[1], coords[2]);
+	uint32_t code = 0;
+	for (int axis = 0; axis < D; axis++)
+	{
+		//Centred on the middle of the bits kept, so a flock around the 
+		//origin doesn't straddle the wrap
+		uint32_t cell = (uint32_t)(coords[axis] + (D == 2 ? 1 << 15 : 1 << 9));
+		code |= (D == 2 ? spreadBits2(cell) : spreadBits3(cell)) << axis;
+	}
+	return code;
+}
 
-	vec3 position = boid->getPosition();
+template<int D>
+void BasicSpacePartition<D>::addActor(int boid, vec position)
+{
+	if (m_mode == PartitionMode::sorted)
+		m_actorsStale = true;
+	else
+		m_actors.insert(boid, getOrAddCell(position));
+	//New actors start out at both widths
+	if (isMigrating())
+		fileAtPendingWidth(boid, position);
+	m_storedObjects++;
+}
 
-	getCell(position).actors.push_back(boid);
+template<int D>
+void BasicSpacePartition<D>::removeActor(int boid)
+{
+	if (m_mode == PartitionMode::sorted)
+		m_actorsStale = true;
+	else
+		m_actors.erase(boid);
+	if (isMigrating() && m_pendingActors.getCell(boid) >= 0)
+		m_pendingActors.erase(boid);
+	m_storedObjects--;
 }
 
-void SpacePartition::removeActor(const Boid* boid)
+template<int D>
+void BasicSpacePartition<D>::renameActor(int oldIndex, int newIndex)
 {
-	if (!boid)
+	if (m_mode == PartitionMode::sorted)
+		m_actorsStale = true;
+	else
+		m_actors.rename(oldIndex, newIndex);
+	if (!isMigrating())
 		return;
+	if (m_pendingActors.getCell(oldIndex) >= 0)
+		m_pendingActors.rename(oldIndex, newIndex);
+	else
+		//An actor yet to move has landed where the migration has been
+		m_migrateCursor = std::min(m_migrateCursor, newIndex);
+}
 
-	vec3 position = boid->getPosition();
+template<int D>
+void BasicSpacePartition<D>::clearActors()
+{
+	m_storedObjects = 0;
+	applyPendingWidth();
+	m_actors.clear();
+	m_sortedActors.clear();
+	m_actorsStale = false;
+	releaseCells();
+}
 
-	getCell(position).actors.remove(boid);
+template<int D>
+void BasicSpacePartition<D>::remapActors(const std::vector<int>& newIndex)
+{
+	if (m_mode == PartitionMode::sorted)
+		m_actorsStale = true;
+	else
+		m_actors.remap(newIndex);
+	if (!isMigrating())
+		return;
+	//Those yet to move could now be anywhere, and are found again by 
+	//skipping over the rest
+	m_pendingActors.remap(newIndex);
+	m_migrateCursor = 0;
 }
 
-void SpacePartition::addObstacle(const Obstacle* obstacle)
+template<int D>
+void BasicSpacePartition<D>::haveMoved(int boid, vec newPosition)
 {
-	if (!obstacle)
+	//Sorted actors are all binned again in one go rather than one by one
+	if (m_mode == PartitionMode::sorted)
+	{
+		m_actorsStale = true;
 		return;
+	}
+
+	if (isMigrating() && m_pendingActors.getCell(boid) >= 0)
+		fileAtPendingWidth(boid, newPosition);
 
-	vec3 position = obstacle->m_position;
+	//Checked against the key first as most moves stay in the same cell
+	int oldCell = m_actors.getCell(boid);
+	if (m_cells.getKey(oldCell) == getCellKey(newPosition))
+		return;
 
-	getCell(position).obstacles.push_back(obstacle);
+	int newCell = getOrAddCell(newPosition);
+
+	m_actors.move(boid, newCell);
+	PROFILE_COUNT(ProfileCounter::cellMoves, 1);
 }
 
-void SpacePartition::removeObstacle(const Obstacle* obstacle)
+template<int D>
+void BasicSpacePartition<D>::setMode(PartitionMode mode, const std::vector<vec>& positions)
 {
-	if (!obstacle)
+	//Everything is refiled below, so there is nothing left to migrate
+	applyPendingWidth();
+	m_mode = mode;
+	m_actors.clear();
+	m_sortedActors.clear();
+	m_actorsStale = false;
+	if (mode == PartitionMode::sorted)
+	{
+		rebuildActors(positions);
 		return;
+	}
 
-	vec3 position = obstacle->m_position;
+	for (int i = 0; i < (int)positions.size(); i++)
+		m_actors.insert(i, getOrAddCell(positions[i]));
+}
 
-	getCell(position).obstacles.remove(obstacle);
+template<int D>
+void BasicSpacePartition<D>::setPartitionWidth(float width)
+{
+	width = clampWidth(width, minWidth);
+	if (width == m_pendingWidth)
+		return;
+	//Drops any half finished change first
+	m_pendingCells.clear();
+	m_pendingActors.clear();
+	m_pendingActors.setCellCount(0);
+	m_migrateCursor = 0;
+	m_pendingWidth = width;
+	if (m_mode == PartitionMode::sorted || m_storedObjects == 0)
+	{
+		applyPendingWidth();
+		m_actorsStale = m_mode == PartitionMode::sorted && m_storedObjects > 0;
+	}
 }
 
-void SpacePartition::haveMoved(const Boid* boid, vec3 oldPosition)
+template<int D>
+void BasicSpacePartition<D>::migrateActors(const std::vector<vec>& positions, int count)
 {
-	if (!boid)
+	if (!isMigrating())
+		return;
+	int total = (int)positions.size();
+	for (; m_migrateCursor < total && count > 0; m_migrateCursor++)
+	{
+		if (m_pendingActors.getCell(m_migrateCursor) >= 0)
+			continue;
+		fileAtPendingWidth(m_migrateCursor, positions[m_migrateCursor]);
+		count--;
+	}
+	if (m_migrateCursor < total)
 		return;
 
-	vec3 position = boid->getPosition();
+	//Every actor is filed at the new width, so those cells take over
+	std::swap(m_cells, m_pendingCells);
+	std::swap(m_actors, m_pendingActors);
+	m_partitionWidth = m_pendingWidth;
+	m_pendingCells.clear();
+	m_pendingActors.clear();
+	m_pendingActors.setCellCount(0);
+	m_migrateCursor = 0;
+	m_sortedActors.setCellCount(0);
+	m_sortedActors.setCellCount(m_cells.size());
+}
 
-	std::list<const Boid*>& newCell = getCell(position).actors;
-	std::list<const Boid*>& oldCell = getCell(oldPosition).actors;
+template<int D>
+void BasicSpacePartition<D>::pruneCells(const std::vector<vec>& positions)
+{
+	resetCells();
+	setMode(m_mode, positions);
+}
 
-	if (newCell == oldCell)
-		return;
-	else
+template<int D>
+void BasicSpacePartition<D>::rebuildActors(const std::vector<vec>& positions)
+{
+	//Binning can add a cell per actor, so the table is emptied first if 
+	//that could take it past the bound. Every actor is binned again anyway
+	if (m_cells.size() > m_storedObjects + spareCells)
+		resetCells();
+	int count = (int)positions.size();
+	m_actorCells.resize(count);
+	for (int i = 0; i < count; i++)
+		m_actorCells[i] = getOrAddCell(positions[i]);
+	m_sortedActors.build(m_actorCells);
+	m_actorsStale = false;
+}
+
+template<int D>
+OccupancyStats BasicSpacePartition<D>::computeOccupancy() const
+{
+	OccupancyStats stats = {};
+	stats.storedCells = m_cells.size();
+	forEachStoredCell([&](int x, int y, int z, int actors)
 	{
-		oldCell.remove(boid);
-		newCell.push_back(boid);
-	}
+		int bucket = 0;
+		while (bucket < OccupancyStats::bucketCount - 1 && 
+			actors >= OccupancyStats::getBucketStart(bucket + 1))
+			bucket++;
+		stats.histogram[bucket]++;
+
+		if (actors > stats.maxActors)
+		{
+			stats.maxActors = actors;
+			stats.maxCellX = x;
+			stats.maxCellY = y;
+			stats.maxCellZ = z;
+		}
+		if (actors > 0)
+			stats.occupiedCells++;
+		stats.totalActors += actors;
+	});
+	stats.meanOccupied = stats.occupiedCells > 0 ? (float)stats.totalActors / stats.occupiedCells : 0.0f;
+	return stats;
 }
 
-SpacePartition::SpacePartition(int sizeX, int sizeY, float partitionWidth) 
-	: m_storedObjects(0), m_sizeX(sizeX), m_sizeY(sizeY), m_partitionWidth(partitionWidth), m_bottomLeft(vec3())
+template<int D>
+BasicSpacePartition<D>::BasicSpacePartition(float partitionWidth) 
+	: m_storedObjects(0), m_partitionWidth(clampWidth(partitionWidth, minWidth)), m_actorsStale(false)
 {
-	m_bottomLeft = vec3(-sizeX * partitionWidth / 2, -sizeY * partitionWidth / 2, 0);
-	m_topRight = vec3(m_bottomLeft.x + (partitionWidth * sizeX), m_bottomLeft.x + (partitionWidth * sizeX), 0);
-	m_partitions.resize(sizeX * sizeY);
+	m_pendingWidth = m_partitionWidth;
 }
 
-SpacePartition::~SpacePartition()
+template<int D>
+BasicSpacePartition<D>::~BasicSpacePartition()
 {
 }
+
+template class BasicSpacePartition<2>;
+template class BasicSpacePartition<3>;
+template CellRange<2> makeCellRange<2>(VecN<2> lo, VecN<2> hi, float cellWidth);
+template CellRange<3> makeCellRange<3>(VecN<3> lo, VecN<3> hi, float cellWidth);
@@ -1,61 +1,255 @@
 #pragma once
 
-#include "vec3.h"
+#include "Dimension.h"
+#include "CellLinks.h"
+#include "SortedCells.h"
+#include "CellHash.h"
 #include <vector>
-#include <list>
-
-class Boid;
-class Obstacle;
+#include <cstdint>
 
+//Block of cell coordinates per axis, top right exclusive
+template<int D>
 struct CellRange
 {
-	int blX, blY;
-	int trX, trY;
-	bool incOOB;
+	int bl[D];
+	int tr[D];
+};
+
+//Cells of the given width overlapping a box given by its lowest and 
+//highest corners, clamped as the cell keys are
+template<int D>
+CellRange<D> makeCellRange(VecN<D> lo, VecN<D> hi, float cellWidth);
+
+//Snapshot of how actors are spread over the cells in use
+struct OccupancyStats
+{
+	//Cells in use holding 0, 1, 2-3, 4-7, ... 64+ actors
+	static const int bucketCount = 8;
+	int histogram[bucketCount];
+	int maxActors;
+	//Z is always 0 in 2D
+	int maxCellX, maxCellY, maxCellZ;
+	//Mean over cells holding at least one actor
+	float meanOccupied;
+	int occupiedCells;
+	//Cells in the hash table, occupied or not
+	int storedCells;
+	int totalActors;
+
+	//Lower bound of a histogram bucket
+	static int getBucketStart(int bucket) { return bucket == 0 ? 0 : 1 << (bucket - 1); }
+};
 
-	CellRange(int bl_X, int bl_Y, int tr_X, int tr_Y, int oob) :
-		blX(bl_X), blY(bl_Y), trX(tr_X), trY(tr_Y), incOOB(oob) {}
+//How a partition keeps track of which cell each actor is in
+enum class PartitionMode
+{
+	//Every actor is linked into its cell and moved between cells as it 
+	//crosses them
+	linked,
+	//Actors are counting sorted into cells once a frame from their 
+	//positions, so each cell is a contiguous run of indices
+	sorted
 };
 
-class SpacePartition
+//Uniform grid of square cells, or cubes in 3D, with no bounds, holding the 
+//actors. Only cells that have been used are stored, in a hash table keyed 
+//by their integer coordinates, so the cost of a query depends on how 
+//crowded the cells around it are and not on where the flock has wandered 
+//to. Cells stay in the table once used until enough lie empty behind a 
+//moving flock that pruneCells is worth calling. Each actor remembers its 
+//cell and is linked into it in place, so filing, moving and removing one 
+//costs the same however crowded the cell is. In sorted mode actors are 
+//instead rebuilt into flat per cell runs whenever they have changed, which 
+//the simulation does once a frame. Obstacles don't move, so they have 
+//their own BasicObstacleIndex
+template<int D>
+class BasicSpacePartition
 {
+public:
+	using vec = VecN<D>;
+	using Range = CellRange<D>;
 private:
-	struct Cell
+	//What a cell holds, as indices into the simulation's boid store. Only 
+	//valid until the partition next changes
+	template<typename Actors>
+	struct CellView
 	{
-		std::list<const Boid*> actors;
-		std::list<const Obstacle*> obstacles;
+		Actors actors;
 	};
+	using LinkedCell = CellView<CellList>;
+	using SortedCell = CellView<CellSpan>;
 
 	int m_storedObjects;
-	int m_sizeX, m_sizeY;
 	float m_partitionWidth;
-	vec3 m_bottomLeft;
-	vec3 m_topRight;
-	std::vector<Cell> m_partitions;
-	Cell m_oob;
+	//Numbers each cell in use, which is what the cell containers are indexed by
+	CellHash m_cells;
+	CellLinks m_actors;
+	PartitionMode m_mode = PartitionMode::linked;
+	//Actors in sorted mode, along with the cell each was last binned into
+	SortedCells m_sortedActors;
+	std::vector<int> m_actorCells;
+	//Set when sorted actors have been added, removed or moved since the 
+	//last rebuild
+	bool m_actorsStale;
+	//A linked partition changes width by filing its actors into a second 
+	//set of cells a slice at a time. Queries keep using the current cells 
+	//until every actor is in the pending ones too, and actors already 
+	//filed there are kept up to date in both. Equal to the current width 
+	//when no change is under way
+	float m_pendingWidth;
+	CellHash m_pendingCells;
+	CellLinks m_pendingActors;
+	//Every actor below this is filed in the pending cells
+	int m_migrateCursor = 0;
+
+	//Z is always 0 in 2D
+	CellHash::Key getCellKey(vec position) const { return getCellKey(position, m_partitionWidth); }
+	CellHash::Key getCellKey(vec position, float width) const;
+	//Number of the cell holding a position, adding the cell if it is new
+	int getOrAddCell(vec position);
+	//Empties the hash table once no actors are filed
+	void releaseCells();
+	//Forgets every cell and unfiles every actor, ready to file them again
+	void resetCells();
+	//Files or refiles an actor in the pending cells
+	void fileAtPendingWidth(int boid, vec position);
+	//Drops the pending cells and takes the pending width straight away, 
+	//for when every actor is about to be filed again anyway
+	void applyPendingWidth();
+	int getActorCount(int index) const;
+	//Calls visit with the number of every cell in the range that is in use
+	template<typename Visit>
+	void forEachCellIndex(const Range& range, Visit visit) const;
 
 public:
-	bool isOutOfBounds(int x, int y) const;
-	bool isOutOfBounds(vec3 position) const;
+	//Cells left empty are only dropped when the table is rebuilt, which is 
+	//worth doing once it holds this many more than twice the actors
+	static constexpr int spareCells = 64;
+	//Narrower widths are raised to this. Keys divide by the width, so zero 
+	//or less would hang every query
+	static constexpr float minWidth = 1.0f;
+
+	int getStoredObjects() const { return m_storedObjects; }
+	int getStoredCells() const { return m_cells.size(); }
+	//Width of the cells queries use
+	float getPartitionWidth() const { return m_partitionWidth; }
+	//Width the partition is moving to, the same as above once it is done
+	float getPendingWidth() const { return m_pendingWidth; }
+	bool isMigrating() const { return m_pendingWidth != m_partitionWidth; }
+	PartitionMode getMode() const { return m_mode; }
+
+	//Walks every stored cell, so this is meant for diagnostics rather than per-boid use
+	OccupancyStats computeOccupancy() const;
+	//Calls visit(x, y, z, actors) for every stored cell, also for diagnostics
+	template<typename Visit>
+	void forEachStoredCell(Visit visit) const;
 
-	int getStoredObjects() { return m_storedObjects; }
-	int getSizeX() { return m_sizeX; }
-	int getSizeY() { return m_sizeY; }
-	const Cell& getOOB() const { return m_oob; }
-	
-	const Cell& getCell(int x, int y) const;
-	Cell& getCell(vec3 position);
+	int getActorCount(int x, int y, int z = 0) const;
 
-	CellRange findCellRange(vec3 position, float radius) const;
+	Range findCellRange(vec position, float radius) const;
+	//Cells overlapping a box given by its lowest and highest corners
+	Range findCellRange(vec lo, vec hi) const;
+	//Z-curve index of the cell holding a position, interleaving the bits of 
+	//its coordinates so cells near each other mostly get nearby codes. Only 
+	//the low bits of each coordinate are used, so cells far apart can share 
+	//a code, which just makes the order less tidy
+	uint32_t getMortonCode(vec position) const;
+	//Calls visit with every cell in the range that is in use. Each cell's 
+	//actors are a CellList when linked and a CellSpan when sorted, so visit 
+	//should be generic over both
+	template<typename Visit>
+	void forEachCell(const Range& range, Visit visit) const;
 
-	void addActor(const Boid* boid);
-	void removeActor(const Boid* boid);
-	void addObstacle(const Obstacle* obstacle);
-	void removeObstacle(const Obstacle* obstacle);
+	void addActor(int boid, vec position);
+	void removeActor(int boid);
+	//Refiles an actor whose index changed because the store filled a gap
+	void renameActor(int oldIndex, int newIndex);
+	//Empties every cell
+	void clearActors();
+	//Renumbers every actor after the store reorders its boids, boid i 
+	//becoming newIndex[i]. Nothing changes cell
+	void remapActors(const std::vector<int>& newIndex);
 
-	void haveMoved(const Boid* boid, vec3 oldPosition);
+	//Refiles an actor if its new position is in another cell
+	void haveMoved(int boid, vec newPosition);
 
-	SpacePartition(int sizeX, int sizeY, float partitionWidth);
+	//Switches how actors are filed and refiles them all, positions[i] 
+	//being where actor i is
+	void setMode(PartitionMode mode, const std::vector<vec>& positions);
+	//Changes the cell width. A sorted partition takes it at its next 
+	//rebuild, which bins every actor anyway. A linked one keeps its current 
+	//cells until migrateActors has filed every actor at the new width
+	void setPartitionWidth(float width);
+	//Files up to count more actors at the pending width, switching over 
+	//once every actor is, positions[i] being where actor i is
+	void migrateActors(const std::vector<vec>& positions, int count);
+	//True once a flock that has moved on has left enough empty cells behind 
+	//that the table should be rebuilt
+	bool hasExcessCells() const { return m_cells.size() > 2 * m_storedObjects + spareCells; }
+	//Numbers the cells afresh with only those holding actors and refiles 
+	//every actor, positions[i] being where actor i is
+	void pruneCells(const std::vector<vec>& positions);
+	//True in sorted mode when the actors need rebuilding before the next query
+	bool needsRebuild() const { return m_actorsStale; }
+	//Counting sorts every actor into its cell from scratch. Sorted mode only
+	void rebuildActors(const std::vector<vec>& positions);
 
-	~SpacePartition();
-};
\ No newline at end of file
+	BasicSpacePartition(float partitionWidth);
+
+	~BasicSpacePartition();
+};
+
+template<int D>
+template<typename Visit>
+void BasicSpacePartition<D>::forEachCell(const Range& range, Visit visit) const
+{
+	//Decided once per query so each cell loop is compiled for one layout
+	if (m_mode == PartitionMode::sorted)
+	{
+		forEachCellIndex(range, [&](int index)
+		{
+			visit(SortedCell{ m_sortedActors.getList(index) });
+		});
+	}
+	else
+	{
+		forEachCellIndex(range, [&](int index)
+		{
+			visit(LinkedCell{ m_actors.getList(index) });
+		});
+	}
+}
+
+template<int D>
+template<typename Visit>
+void BasicSpacePartition<D>::forEachCellIndex(const Range& range, Visit visit) const
+{
+	int zBegin = D == 3 ? range.bl[D - 1] : 0;
+	int zEnd = D == 3 ? range.tr[D - 1] : 1;
+	for (int z = zBegin; z < zEnd; z++)
+	{
+		for (int y = range.bl[1]; y < range.tr[1]; y++)
+		{
+			//X is the low part of the key, and the range is already clamped
+			CellHash::Key key = CellHash::makeKey(range.bl[0], y, z);
+			for (int x = range.bl[0]; x < range.tr[0]; x++, key++)
+			{
+				int cell = m_cells.find(key);
+				if (cell >= 0)
+					visit(cell);
+			}
+		}
+	}
+}
+
+template<int D>
+template<typename Visit>
+void BasicSpacePartition<D>::forEachStoredCell(Visit visit) const
+{
+	for (int cell = 0; cell < m_cells.size(); cell++)
+	{
+		int x, y, z;
+		CellHash::splitKey(m_cells.getKey(cell), x, y, z);
+		visit(x, y, z, getActorCount(cell));
+	}
+}
@@ -0,0 +1,31 @@
+#include "SpatialIndex.h"
+#include <cstring>
+
+const char* getSpatialIndexName(SpatialIndexType type)
+{
+	switch (type)
+	{
+	case SpatialIndexType::grid:
+		return "grid";
+	case SpatialIndexType::kdTree:
+		return "kdtree";
+	case SpatialIndexType::bvh:
+		return "bvh";
+	}
+	return "unknown";
+}
+
+bool parseSpatialIndexName(const char* name, SpatialIndexType& type)
+{
+	const SpatialIndexType types[3] = { SpatialIndexType::grid, 
+		SpatialIndexType::kdTree, SpatialIndexType::bvh };
+	for (SpatialIndexType candidate : types)
+	{
+		if (std::strcmp(name, getSpatialIndexName(candidate)) == 0)
+		{
+			type = candidate;
+			return true;
+		}
+	}
+	return false;
+}
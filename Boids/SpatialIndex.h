@@ -0,0 +1,75 @@
+#pragma once
+
+#include "SpacePartition.h"
+#include <vector>
+
+//Spatial indices are plugged into steering at compile time rather than
+//through a base class, so every query loop is inlined for its backend. An
+//index over actor positions provides:
+//
+//	void build(const std::vector<vec>& positions)
+//		Files every actor from scratch, positions[i] being where actor i is
+//	void update(const std::vector<vec>& positions)
+//		Catches up after actors have moved, been added or been removed. May
+//		be cheaper than a build, or the same
+//	template<typename Visit> void queryRadius(vec centre, float radius, Visit visit) const
+//	template<typename Visit> void queryBox(vec lo, vec hi, Visit visit) const
+//		Call visit(int actor) in place for every actor within the region.
+//		Backends may also pass some just outside it, so callers still check
+//		distances themselves
+//
+//Indices only hold actors. Obstacles never move, so they have their own
+//BasicObstacleIndex whatever backend steers the actors
+enum class SpatialIndexType
+{
+	//The simulation's own partition, bucketing actors into uniform cells
+	grid,
+	//Median split kd-tree rebuilt every frame
+	kdTree,
+	//Dynamic bounding volume hierarchy that only refiles actors that have
+	//left their leaf's box
+	bvh
+};
+
+//Names used by the command line tools
+const char* getSpatialIndexName(SpatialIndexType type);
+bool parseSpatialIndexName(const char* name, SpatialIndexType& type);
+
+//Queries a partition's cells as a spatial index. The partition keeps
+//itself up to date, so building and updating do nothing
+template<int D>
+class GridIndex
+{
+public:
+	using vec = VecN<D>;
+private:
+	const BasicSpacePartition<D>& m_partition;
+
+	template<typename Visit>
+	void visitRange(const CellRange<D>& range, Visit visit) const
+	{
+		m_partition.forEachCell(range, [&](const auto& cell)
+		{
+			for (int actor : cell.actors)
+				visit(actor);
+		});
+	}
+public:
+	void build(const std::vector<vec>&) {}
+	void update(const std::vector<vec>&) {}
+
+	//Visits every actor in the cells the circle or sphere touches
+	template<typename Visit>
+	void queryRadius(vec centre, float radius, Visit visit) const
+	{
+		visitRange(m_partition.findCellRange(centre, radius), visit);
+	}
+	//Visits every actor in the cells the box touches
+	template<typename Visit>
+	void queryBox(vec lo, vec hi, Visit visit) const
+	{
+		visitRange(m_partition.findCellRange(lo, hi), visit);
+	}
+
+	GridIndex(const BasicSpacePartition<D>& partition) : m_partition(partition) {}
+};
@@ -0,0 +1,134 @@
+#include "TraceRecorder.h"
+#include "Profiler.h"
+#include <fstream>
+#include <iomanip>
+
+namespace
+{
+	struct ThreadSlot
+	{
+		void* buffer = nullptr;
+		unsigned generation = 0;
+	};
+	thread_local ThreadSlot t_slot;
+}
+
+TraceRecorder::TraceRecorder() : m_capturing(false), m_generation(0)
+{
+}
+
+TraceRecorder& TraceRecorder::get()
+{
+	static TraceRecorder recorder;
+	return recorder;
+}
+
+void TraceRecorder::start(int frames)
+{
+	std::lock_guard<std::mutex> lock(m_mutex);
+	m_buffers.clear();
+	m_frames.clear();
+	//Invalidates every thread's cached buffer
+	m_generation.fetch_add(1);
+	m_captureStart = std::chrono::steady_clock::now();
+	m_frameStart = m_captureStart;
+	m_framesRemaining = frames;
+	m_capturing.store(frames > 0);
+}
+
+bool TraceRecorder::hasCapture() const
+{
+	return !isCapturing() && !m_frames.empty();
+}
+
+TraceRecorder::ThreadBuffer& TraceRecorder::getThreadBuffer()
+{
+	unsigned generation = m_generation.load(std::memory_order_relaxed);
+	if (t_slot.buffer && t_slot.generation == generation)
+		return *static_cast<ThreadBuffer*>(t_slot.buffer);
+
+	std::lock_guard<std::mutex> lock(m_mutex);
+	m_buffers.emplace_back(new ThreadBuffer());
+	m_buffers.back()->thread = (int)m_buffers.size();
+	t_slot.buffer = m_buffers.back().get();
+	t_slot.generation = generation;
+	return *m_buffers.back();
+}
+
+double TraceRecorder::toMicroseconds(std::chrono::steady_clock::time_point time) const
+{
+	return std::chrono::duration<double, std::micro>(time - m_captureStart).count();
+}
+
+void TraceRecorder::record(ProfilePhase phase, std::chrono::steady_clock::time_point start,
+	std::chrono::steady_clock::time_point end, const float* position)
+{
+	if (!isCapturing())
+		return;
+
+	Event event;
+	event.phase = (int)phase;
+	event.start = toMicroseconds(start);
+	event.duration = std::chrono::duration<double, std::micro>(end - start).count();
+	event.hasPosition = position != nullptr;
+	event.x = position ? position[0] : 0.0f;
+	event.y = position ? position[1] : 0.0f;
+	getThreadBuffer().events.push_back(event);
+}
+
+void TraceRecorder::endFrame()
+{
+	if (!isCapturing())
+		return;
+
+	auto now = std::chrono::steady_clock::now();
+	Event frame = { -1, toMicroseconds(m_frameStart), 
+		std::chrono::duration<double, std::micro>(now - m_frameStart).count(), false, 0.0f, 0.0f };
+	m_frames.push_back(frame);
+	m_frameStart = now;
+
+	if (--m_framesRemaining <= 0)
+		m_capturing.store(false);
+}
+
+bool TraceRecorder::write(const std::string& path)
+{
+	std::ofstream file(path);
+	if (!file)
+		return false;
+
+	std::lock_guard<std::mutex> lock(m_mutex);
+	file << std::fixed << std::setprecision(3);
+	file << "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[\n";
+	file << "{\"name\":\"process_name\",\"ph\":\"M\",\"pid\":1,\"args\":{\"name\":\"Boids\"}}";
+	for (size_t i = 0; i < m_frames.size(); i++)
+	{
+		file << ",\n{\"name\":\"Frame " << i << "\",\"cat\":\"frame\",\"ph\":\"X\",\"pid\":1,\"tid\":0,\"ts\":"
+			<< m_frames[i].start << ",\"dur\":" << m_frames[i].duration << "}";
+	}
+	file << ",\n{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":0,\"args\":{\"name\":\"Frames\"}}";
+
+	for (const std::unique_ptr<ThreadBuffer>& buffer : m_buffers)
+	{
+		file << ",\n{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":" << buffer->thread
+			<< ",\"args\":{\"name\":\"Thread " << buffer->thread << "\"}}";
+		for (const Event& event : buffer->events)
+		{
+			ProfilePhase phase = (ProfilePhase)event.phase;
+			bool isRender = phase == ProfilePhase::boidDraw || phase == ProfilePhase::auraDraw ||
+				phase == ProfilePhase::obstacleDraw;
+			//Phase names are indented for the profiler panel, skip that here
+			const char* name = Profiler::getPhaseName(phase);
+			while (*name == ' ')
+				name++;
+			file << ",\n{\"name\":\"" << name << "\",\"cat\":\"" << (isRender ? "render" : "sim")
+				<< "\",\"ph\":\"X\",\"pid\":1,\"tid\":" << buffer->thread << ",\"ts\":" << event.start
+				<< ",\"dur\":" << event.duration;
+			if (event.hasPosition)
+				file << ",\"args\":{\"x\":" << event.x << ",\"y\":" << event.y << "}";
+			file << "}";
+		}
+	}
+	file << "\n]}\n";
+	return true;
+}
@@ -0,0 +1,64 @@
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+enum class ProfilePhase;
+
+//Records every profiled scope with its thread for a fixed number of frames 
+//and writes them as Chrome trace-event JSON, loadable in Perfetto or 
+//chrome://tracing
+class TraceRecorder
+{
+private:
+	struct Event
+	{
+		int phase;
+		//Microseconds since the capture started
+		double start;
+		double duration;
+		bool hasPosition;
+		float x, y;
+	};
+
+	struct ThreadBuffer
+	{
+		int thread;
+		std::vector<Event> events;
+	};
+
+	std::atomic<bool> m_capturing;
+	std::atomic<unsigned> m_generation;
+	std::mutex m_mutex;
+	std::vector<std::unique_ptr<ThreadBuffer>> m_buffers;
+	std::vector<Event> m_frames;
+	std::chrono::steady_clock::time_point m_captureStart;
+	std::chrono::steady_clock::time_point m_frameStart;
+	int m_framesRemaining = 0;
+
+	ThreadBuffer& getThreadBuffer();
+	double toMicroseconds(std::chrono::steady_clock::time_point time) const;
+public:
+	TraceRecorder();
+
+	static TraceRecorder& get();
+
+	//Discards any previous capture and records the next frames
+	void start(int frames);
+	bool isCapturing() const { return m_capturing.load(std::memory_order_relaxed); }
+	//True once a capture has finished and not been cleared
+	bool hasCapture() const;
+
+	//Position is optional and is attached to the event so per-boid spikes 
+	//can be traced back to a place in the world
+	void record(ProfilePhase phase, std::chrono::steady_clock::time_point start,
+		std::chrono::steady_clock::time_point end, const float* position = nullptr);
+	//Marks a frame boundary, stopping the capture after the requested count
+	void endFrame();
+
+	bool write(const std::string& path);
+};
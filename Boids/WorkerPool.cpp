@@ -0,0 +1,78 @@
+#include "WorkerPool.h"
+#include <algorithm>
+
+WorkerPool::WorkerPool(int threadCount)
+{
+	for (int i = 1; i < std::max(1, threadCount); i++)
+		m_threads.emplace_back(&WorkerPool::workerLoop, this, i);
+}
+
+WorkerPool::~WorkerPool()
+{
+	{
+		std::lock_guard<std::mutex> lock(m_mutex);
+		m_stopping = true;
+	}
+	m_wake.notify_all();
+	for (std::thread& thread : m_threads)
+		thread.join();
+}
+
+void WorkerPool::runChunk(const Job& job, int count, int thread) const
+{
+	int threads = getThreadCount();
+	int begin = (int)((long long)count * thread / threads);
+	int end = (int)((long long)count * (thread + 1) / threads);
+	if (begin < end)
+		job(begin, end, thread);
+}
+
+void WorkerPool::workerLoop(int thread)
+{
+	unsigned long long seenGeneration = 0;
+	while (true)
+	{
+		const Job* job;
+		int count;
+		{
+			std::unique_lock<std::mutex> lock(m_mutex);
+			m_wake.wait(lock, [&] { return m_stopping || m_generation != seenGeneration; });
+			if (m_stopping)
+				return;
+			seenGeneration = m_generation;
+			job = m_job;
+			count = m_count;
+		}
+
+		runChunk(*job, count, thread);
+
+		std::lock_guard<std::mutex> lock(m_mutex);
+		if (--m_pending == 0)
+			m_done.notify_one();
+	}
+}
+
+void WorkerPool::parallelFor(int count, const Job& job)
+{
+	if (m_threads.empty())
+	{
+		if (count > 0)
+			job(0, count, 0);
+		return;
+	}
+
+	{
+		std::lock_guard<std::mutex> lock(m_mutex);
+		m_job = &job;
+		m_count = count;
+		m_pending = (int)m_threads.size();
+		m_generation++;
+	}
+	m_wake.notify_all();
+
+	runChunk(job, count, 0);
+
+	std::unique_lock<std::mutex> lock(m_mutex);
+	m_done.wait(lock, [&] { return m_pending == 0; });
+	m_job = nullptr;
+}
@@ -0,0 +1,38 @@
+#pragma once
+
+#include <condition_variable>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+//Persistent set of threads for splitting per-boid work. The calling thread 
+//takes the first chunk itself, so a pool of one thread runs inline
+class WorkerPool
+{
+public:
+	//Called with a [begin, end) range and the index of the thread running it
+	using Job = std::function<void(int begin, int end, int thread)>;
+private:
+	std::vector<std::thread> m_threads;
+	std::mutex m_mutex;
+	std::condition_variable m_wake;
+	std::condition_variable m_done;
+	const Job* m_job = nullptr;
+	int m_count = 0;
+	int m_pending = 0;
+	unsigned long long m_generation = 0;
+	bool m_stopping = false;
+
+	void workerLoop(int thread);
+	void runChunk(const Job& job, int count, int thread) const;
+public:
+	explicit WorkerPool(int threadCount);
+	~WorkerPool();
+
+	int getThreadCount() const { return (int)m_threads.size() + 1; }
+
+	//Splits [0, count) into one contiguous chunk per thread and returns 
+	//once every chunk has finished
+	void parallelFor(int count, const Job& job);
+};
@@ -1,17 +1,22 @@
-#include "vec3.h"
-#include "Boid.h"
+#include "vec2.h"
+#include "BoidStore.h"
 #include "Obstacle.h"
 #include "Renderer.h"
 #include "VertexArray.h"
 #include "Shader.h"
 #include "Texture.h"
-#include "SpacePartition.h"
+#include "Simulation.h"
+#include "EntityRenderer.h"
+#include "Profiler.h"
+#include "ProfilerPanel.h"
+#include "PartitionPanel.h"
 
 #include <iostream>
 #include <string>
 #include <random>
 #include <vector>
-#include <ctime>
+#include <thread>
+#include <algorithm>
 
 #include "glm/glm.hpp"
 #include "glm/gtc/matrix_transform.hpp"
@@ -22,6 +27,8 @@
 #include <math.h>
 
 static int initialValues[2] = { 100, 10 };
+static int spawnPattern = (int)SpawnPattern::uniformBox;
+static int spawnSeed = 0;
 
 static int screenWidth = 1350;
 static int screenHeight = 900;
@@ -49,69 +56,27 @@ void scroll_callback(GLFWwindow* window, double xoffset, double yoffset)
 	scrollMoved += yoffset;
 }
 
-void fillEntities(int numBoids, int numObst, float obstRadius, 
-	std::vector<Boid>& boids, std::vector<Obstacle>& obstacles,
-	SpacePartition& spacePartition, VertexArray& vao, IndexBuffer& ib, 
-	Texture& actorTex, Texture& rTex, Texture& bTex, Shader& shader)
+Scenario makeScenario(float obstRadius)
 {
-	//Create a set of boids
-	boids.reserve(numBoids);
-	for (int i = 0; i < numBoids; i++)
-	{
-		vec3 pos = vec3((float)(rand() % 201) - 100, (float)(rand() % 201) - 100, 0.0f);
-		vec3 vel = vec3((float)(rand() % 7) - 3, (float)(rand() % 7) - 3, 0.0f);
-		//start pos, start velocity, max acceleration, drag, 
-		boids.emplace_back(pos, vel, spacePartition, vao, ib, actorTex, rTex, bTex, shader);
-	}
-
-	//Create a set of obstacles
-	obstacles.reserve(numObst);
-	for (int i = 0; i < numObst; i++)
-	{
-		vec3 position = vec3((rand() % 201) - 100, (rand() % 201) - 100, 0.0f);
-		obstacles.emplace_back(position, obstRadius, spacePartition);
-	}
-}
-
-void setUpCircle(float obstRadius, std::vector<Boid>& boids, 
-	std::vector<Obstacle>& obstacles, SpacePartition& partition)
-{
-	float angle = 0.0f;
-	//Align boids to circle
-	for (int i = 0; i < boids.size(); i++)
-	{
-		vec3 pos = vec3(cos(angle) * 80.0f, sin(angle) * 80.0f, 0.0f);
-		vec3 vel = vec3()-pos.unit();
-		boids[i].setPosition(pos);
-		boids[i].setVelocity(vel);
-		boids[i].setHomeDist(1.0f);
-		boids[i].setHomeLocation(vec3() - pos);
-		angle += (2 * M_PI / boids.size());
-	}
-	int numObst = obstacles.size();
-	obstacles.clear();
-	obstacles.reserve(numObst);
-	//Align obstacles to inner circle
-	for (int i = 0; i < numObst; i++)
-	{
-		angle += (2 * M_PI / numObst);
-		vec3 position = vec3(cos(angle) * 40.0f, sin(angle) * 40.0f, 0.0f);
-		obstacles.emplace_back(position, obstRadius, partition);
-	}
+	Scenario scenario;
+	scenario.pattern = (SpawnPattern)spawnPattern;
+	scenario.numBoids = initialValues[0];
+	scenario.numObstacles = initialValues[1];
+	scenario.obstacleRadius = obstRadius;
+	scenario.seed = (uint32_t)spawnSeed;
+	return scenario;
 }
 
 enum class Placement
 {
 	actor,
 	obstacle,
-	destination
+	destination,
+	erase
 };
 
 int main()
 {
-	//Basic setup
-	std::srand(std::time(NULL));
-	
 	// Initialize the library
 	if (!glfwInit())
 		return -1;
@@ -183,6 +148,8 @@ int main()
 		shader.unbind();
 
 		Renderer renderer;
+		EntityRenderer entityRenderer(renderer, vao, ib, shader, 
+			actorTex, obstTex, destTex, rTex, bTex);
 
 		ImGui::CreateContext();
 		ImGui_ImplGlfwGL3_Init(window, true);
@@ -198,32 +165,23 @@ int main()
 		float orthoWidth = orthoHeight * screenWidth / screenHeight;
 		glm::vec3 translation = glm::vec3(0.0f, 0.0f, 0.0f);
 
-		//Create space partitioning
-		SpacePartition spacePartition = SpacePartition(48, 48, 10.0f);
+		//Create the simulation and its space partitioning
+		Simulation simulation(10.0f);
 
 		//Setting up boid properties (updated each frame)
 		float simSpeed = 1.0f;
-		float boidAcc = 0.1f;
-		float boidSpeed = 1.0f;
-		float boidHome = 60.0f;
-		float boidView = 0.5f;
-		float boidRadius = 2.0f;
-		float boidAvoid = 20.0f;
-		float boidDetect = 11.0f;
+		int steeringThreads = 1;
+		int maxThreads = std::max(1, (int)std::thread::hardware_concurrency());
+		ActorSettings settings;
 		float obstRadius = 2.0f;
-		bool boidFlocking = true;
-		bool boidClearPathUse = false;
+		float eraseRadius = 5.0f;
 		bool updateSettings = true;
 		bool drawAvoid = false;
 		bool drawDetect = false;
-		vec3 destination = vec3();
 		Placement placeType = Placement::actor;
 
 		//Create a set of boids and obstacles
-		std::vector<Boid> boids;
-		std::vector<Obstacle> obstacles;
-		fillEntities(initialValues[0], initialValues[1], obstRadius, boids, obstacles, spacePartition,
-			vao, ib, actorTex, rTex, bTex, shader);
+		uint32_t currentSeed = simulation.fillEntities(makeScenario(obstRadius));
 
 		//Set callback triggers
 		glfwSetWindowSizeCallback(window, window_size_callback);
@@ -256,7 +214,7 @@ int main()
 				glfwGetCursorPos(window, &mouseX, &mouseY);
 				mouseX = (mouseX * orthoWidth * 2 / screenWidth) - orthoWidth;
 				mouseY = (double)orthoHeight - (mouseY * orthoHeight * 2 / screenHeight);
-				vec3 clickPosition((float)mouseX - translation.x, (float)mouseY - translation.y, 0.0f);
+				vec2 clickPosition((float)mouseX - translation.x, (float)mouseY - translation.y);
 
 				int lmb = lmbPressed;
 				lmbPressed = 0;
@@ -272,27 +230,17 @@ int main()
 					switch (placeType)
 					{
 					case Placement::actor:
-					{
-						boids.emplace_back(clickPosition, vec3(), spacePartition,
-							vao, ib, actorTex, rTex, bTex, shader);
-						Boid& boid = boids[boids.size() - 1];
-						boid.setMaxAcceleration(boidAcc);
-						boid.setSpeed(boidSpeed);
-						boid.setHomeDist(boidHome);
-						boid.setViewArc(boidView);
-						boid.setRadius(boidRadius);
-						boid.setAvoidanceDist(boidAvoid);
-						boid.setDetectionDist(boidDetect);
-						boid.setClearUsage(boidClearPathUse);
-						boid.setFlocking(boidFlocking);
-						boid.setHomeLocation(destination);
-					}
+						simulation.applySettings(
+							simulation.addBoid(clickPosition, vec2()), settings);
 						break;
 					case Placement::obstacle:
-						obstacles.emplace_back(clickPosition, obstRadius, spacePartition);
+						simulation.addObstacle(clickPosition, obstRadius);
 						break;
 					case Placement::destination:
-						destination = clickPosition;
+						settings.homeLocation = clickPosition;
+						break;
+					case Placement::erase:
+						simulation.removeNear(clickPosition, eraseRadius);
 						break;
 					}
 				}
@@ -310,19 +258,34 @@ int main()
 			{
 				//static int counter = 0;
 				ImGui::SliderFloat("Simulation speed", &simSpeed, 0.0f, 1.0f);
+				if (ImGui::SliderInt("Steering threads", &steeringThreads, 1, maxThreads))
+					simulation.setThreadCount(steeringThreads);
+				bool sortedPartition = simulation.getPartitionMode() == PartitionMode::sorted;
+				if (ImGui::Checkbox("Rebuild partition each frame", &sortedPartition))
+					simulation.setPartitionMode(sortedPartition ? PartitionMode::sorted : PartitionMode::linked);
+				//In the enum's order
+				int spatialIndex = (int)simulation.getSpatialIndex();
+				if (ImGui::Combo("Neighbour index", &spatialIndex, "Grid\0Kd-tree\0BVH\0"))
+					simulation.setSpatialIndex((SpatialIndexType)spatialIndex);
+				//Refiles between frames when the radii sliders or the flock call for it
+				bool autoCellWidth = simulation.getAutoCellWidth();
+				if (ImGui::Checkbox("Tune cell width", &autoCellWidth))
+					simulation.setAutoCellWidth(autoCellWidth);
+				ImGui::SameLine();
+				ImGui::Text("%.1f", simulation.getPartition().getPartitionWidth());
 				ImGui::Text("Actor settings");
-				ImGui::SliderFloat("Max Acceleration", &boidAcc, 0.01f, 0.2f);
-				ImGui::SliderFloat("Max Speed", &boidSpeed, 0.01f, 1.0f);
-				ImGui::SliderFloat("Home Bounds", &boidHome, 1.0f, 200.0f);
-				ImGui::SliderFloat("View Arc", &boidView, 0.0f, 1.0f);
-				ImGui::SliderFloat("Radius", &boidRadius, 0.1f, 20.0f);
-				ImGui::SliderFloat("Avoidance Distance", &boidAvoid, 0.0f, 100.0f);
-				ImGui::SliderFloat("Detection Distance", &boidDetect, 0.0f, 100.0f);
+				ImGui::SliderFloat("Max Acceleration", &settings.maxAcceleration, 0.01f, 0.2f);
+				ImGui::SliderFloat("Max Speed", &settings.speed, 0.01f, 1.0f);
+				ImGui::SliderFloat("Home Bounds", &settings.homeDist, 1.0f, 200.0f);
+				ImGui::SliderFloat("View Arc", &settings.viewArc, 0.0f, 1.0f);
+				ImGui::SliderFloat("Radius", &settings.radius, 0.1f, 20.0f);
+				ImGui::SliderFloat("Avoidance Distance", &settings.avoidanceDist, 0.0f, 100.0f);
+				ImGui::SliderFloat("Detection Distance", &settings.detectionDist, 0.0f, 100.0f);
 				ImGui::SliderFloat("Obstacle Radius", &obstRadius, 0.1f, 20.0f);
 
-				ImGui::Checkbox("Use RVO collision avoidance", &boidClearPathUse);
+				ImGui::Checkbox("Use RVO collision avoidance", &settings.useClearPath);
 				ImGui::SameLine();
-				ImGui::Checkbox("Use flocking behaviour", &boidFlocking);
+				ImGui::Checkbox("Use flocking behaviour", &settings.useFlocking);
 
 				ImGui::Checkbox("Draw avoidance", &drawAvoid);
 				ImGui::SameLine();
@@ -334,33 +297,22 @@ int main()
 
 				if (ImGui::Button("Restart"))
 				{
-					boids.clear();
-					obstacles.clear();
+					simulation.clear();
 					orthoHeight = 100.0f;
 					orthoWidth = orthoHeight * screenWidth / screenHeight;
 					translation = glm::vec3(0.0f, 0.0f, 0.0f);
-					fillEntities(initialValues[0], initialValues[1], obstRadius, boids, obstacles, 
-						spacePartition, vao, ib, actorTex, rTex, bTex, shader);
-					for (Boid& boid : boids)
-					{
-						boid.setMaxAcceleration(boidAcc);
-						boid.setSpeed(boidSpeed);
-						boid.setHomeDist(boidHome);
-						boid.setViewArc(boidView);
-						boid.setRadius(boidRadius);
-						boid.setAvoidanceDist(boidAvoid);
-						boid.setDetectionDist(boidDetect);
-						boid.setClearUsage(boidClearPathUse);
-						boid.setFlocking(boidFlocking);
-						boid.setHomeLocation(destination);
-					}
+					currentSeed = simulation.fillEntities(makeScenario(obstRadius));
+					simulation.applySettings(settings);
 				}
 				ImGui::SameLine();
 				ImGui::InputInt2("", &initialValues[0]);
+				ImGui::Combo("Spawn pattern", &spawnPattern, "Uniform box\0Gaussian clusters\0Ring\0Dense clump\0");
+				ImGui::InputInt("Seed (0 = random)", &spawnSeed);
+				ImGui::Text("Current seed: %u", currentSeed);
 				if (ImGui::Button("Circle Test"))
 				{
 					updateSettings = false;
-					setUpCircle(obstRadius, boids, obstacles, spacePartition);
+					simulation.setUpCircle(obstRadius);
 				}
 
 				if (ImGui::Button("Place actor"))
@@ -371,6 +323,9 @@ int main()
 				ImGui::SameLine();
 				if (ImGui::Button("Place destination"))
 					placeType = Placement::destination;
+				ImGui::SameLine();
+				if (ImGui::Button("Erase"))
+					placeType = Placement::erase;
 				switch (placeType)
 				{
 				case Placement::actor:
@@ -382,6 +337,10 @@ int main()
 				case Placement::destination:
 					ImGui::Text("RMB places the destination");
 					break;
+				case Placement::erase:
+					ImGui::Text("RMB removes everything within the erase radius");
+					ImGui::SliderFloat("Erase radius", &eraseRadius, 1.0f, 50.0f);
+					break;
 				}
 				ImGui::Text("Scroll wheel zooms and arrow keys pan camera");
 				ImGui::Text("Application average %.3f ms/frame (%.1f FPS)", 1000.0f / ImGui::GetIO().Framerate, ImGui::GetIO().Framerate);
@@ -393,70 +352,47 @@ int main()
 			glm::mat4 viewProjection = projection * view;
 
 			//Draw current destination marker
-			{
-				glm::mat4 model = glm::translate(glm::mat4(1.0f), glm::vec3(destination.x, destination.y, destination.z));
-				glm::mat4 modelViewProjection = viewProjection * model;
-
-				shader.bind();
-				destTex.bind(0);
-				shader.setUniform1i("u_texture", 0);
-				shader.setUniformMat4f("u_modelViewProjection", modelViewProjection);
+			entityRenderer.drawDestination(settings.homeLocation, viewProjection);
 
-				renderer.draw(vao, ib, shader);
-			}
+			//Allow for in flight adjustments
+			if (updateSettings)
+				simulation.applySettings(settings);
 
-			for (Boid& boid : boids)
+			//Run boid steering
+			simulation.steering();
+			//Draw radii
 			{
-				//Allow for in flight adjustments
-				if (updateSettings)
-				{
-					boid.setMaxAcceleration(boidAcc);
-					boid.setSpeed(boidSpeed);
-					boid.setHomeDist(boidHome);
-					boid.setViewArc(boidView);
-					boid.setRadius(boidRadius);
-					boid.setAvoidanceDist(boidAvoid);
-					boid.setDetectionDist(boidDetect);
-					boid.setClearUsage(boidClearPathUse);
-					boid.setFlocking(boidFlocking);
-					boid.setHomeLocation(destination);
-				}
-				//Run boid steering
-				boid.steering();
-				//Draw radii
-				boid.drawAuras(renderer, viewProjection, drawAvoid, drawDetect);
+				PROFILE_SCOPE(ProfilePhase::auraDraw);
+				const BoidStore& boids = simulation.getBoids();
+				for (int i = 0; i < boids.size(); i++)
+					entityRenderer.drawAuras(boids, i, viewProjection, drawAvoid, drawDetect);
 			}
-			
-			for (Boid& boid : boids)
+
+			simulation.locomotion(simSpeed);
 			{
-				boid.locomotion(simSpeed);
-				boid.draw(renderer, viewProjection);
+				PROFILE_SCOPE(ProfilePhase::boidDraw);
+				const BoidStore& boids = simulation.getBoids();
+				for (int i = 0; i < boids.size(); i++)
+					entityRenderer.drawBoid(boids, i, viewProjection);
 			}
 
-			for (Obstacle& obst : obstacles)
+			if (updateSettings)
+				simulation.setObstacleRadius(obstRadius);
 			{
-				if (updateSettings)
-					obst.m_radius = obstRadius;
-
-				vec3 pos = obst.m_position;
-				glm::mat4 scale = glm::scale(glm::mat4(1.0f), glm::vec3(obst.m_radius / 2));
-				glm::mat4 model = glm::translate(glm::mat4(1.0f), glm::vec3(pos.x, pos.y, pos.z));
-				glm::mat4 modelViewProjection = viewProjection * model * scale;
-
-				shader.bind();
-				obstTex.bind(0);
-				shader.setUniform1i("u_texture", 0);
-				shader.setUniformMat4f("u_modelViewProjection", modelViewProjection);
-
-				renderer.draw(vao, ib, shader);
+				PROFILE_SCOPE(ProfilePhase::obstacleDraw);
+				for (const Obstacle& obst : simulation.getObstacles())
+					entityRenderer.drawObstacle(obst, viewProjection);
 			}
 			ImGui::End();
+			drawProfilerPanel();
+			drawPartitionPanel(simulation.getPartition(), viewProjection, screenWidth, screenHeight);
 			//Rendering GUI
 			ImGui::Render();
 			ImGui_ImplGlfwGL3_RenderDrawData(ImGui::GetDrawData());
 
 			glfwSwapBuffers(window);
 			glfwPollEvents();
+			Profiler::get().endFrame();
 		}
 	}
 
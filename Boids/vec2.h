@@ -0,0 +1,58 @@
+#pragma once
+#include <cmath>
+#include <type_traits>
+
+//The 2D simulation uses this rather than carrying a vec3 with z always 0. 
+//Header only and trivially copyable like vec3
+class vec2
+{
+public:
+	float x, y;
+
+	constexpr vec2() : x(0.0f), y(0.0f) {}
+	constexpr vec2(float a, float b) : x(a), y(b) {}
+
+	//Component by axis, for code written over any dimension
+	constexpr float operator[](int axis) const { return axis == 0 ? x : y; }
+
+	constexpr float square() const { return (x * x) + (y * y); }
+	float mag() const { return std::sqrt(square()); }
+	constexpr float dot(const vec2& other) const { return (x * other.x) + (y * other.y); }
+	constexpr float distSquare(const vec2& other) const { return (*this - other).square(); }
+	//Zero and unit length vectors are returned unchanged
+	vec2 unit() const
+	{
+		float m = mag();
+		if (m != 1.0f && m != 0.0f)
+		{
+			float inv = 1.0f / m;
+			return vec2(x * inv, y * inv);
+		}
+		return *this;
+	}
+	//this + dir * scale
+	constexpr vec2 mulAdd(const vec2& dir, float scale) const { return vec2(x + dir.x * scale, y + dir.y * scale); }
+	//Removes the component along a unit length direction
+	constexpr vec2 reject(const vec2& unitDir) const { return mulAdd(unitDir, -dot(unitDir)); }
+	//Rotated a quarter turn anticlockwise
+	constexpr vec2 perp() const { return vec2(-y, x); }
+	//Z of the 3D cross product, positive when other is anticlockwise of this
+	constexpr float cross(const vec2& other) const { return (x * other.y) - (y * other.x); }
+	//Per axis minimum and maximum, for bounding boxes
+	constexpr vec2 min(const vec2& other) const { return vec2(x < other.x ? x : other.x, y < other.y ? y : other.y); }
+	constexpr vec2 max(const vec2& other) const { return vec2(x > other.x ? x : other.x, y > other.y ? y : other.y); }
+
+	constexpr bool operator==(const vec2& rhs) const { return x == rhs.x && y == rhs.y; }
+	constexpr bool operator!=(const vec2& rhs) const { return !(*this == rhs); }
+	constexpr vec2 operator-() const { return vec2(-x, -y); }
+	constexpr vec2 operator+(const vec2& rhs) const { return vec2(x + rhs.x, y + rhs.y); }
+	constexpr vec2& operator+=(const vec2& rhs) { x += rhs.x; y += rhs.y; return *this; }
+	constexpr vec2 operator-(const vec2& rhs) const { return vec2(x - rhs.x, y - rhs.y); }
+	constexpr vec2& operator-=(const vec2& rhs) { x -= rhs.x; y -= rhs.y; return *this; }
+	constexpr vec2 operator*(const vec2& rhs) const { return vec2(x * rhs.x, y * rhs.y); }
+	constexpr vec2 operator*(float rhs) const { return vec2(x * rhs, y * rhs); }
+	constexpr vec2 operator/(const vec2& rhs) const { return vec2(x / rhs.x, y / rhs.y); }
+	constexpr vec2 operator/(float rhs) const { return vec2(x / rhs, y / rhs); }
+};
+
+static_assert(std::is_trivially_copyable<vec2>::value, "vec2 must stay trivially copyable");
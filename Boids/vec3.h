@@ -1,27 +1,67 @@
 #pragma once
+#include <cmath>
+#include <type_traits>
+
+//Header only and trivially copyable so every operation inlines into the 
+//steering loops and arrays of vectors can be copied as raw memory
 class vec3
 {
 public:
 	float x, y, z;
 
-	vec3();
-	vec3(float a, float b, float c);
-	~vec3();
+	constexpr vec3() : x(0.0f), y(0.0f), z(0.0f) {}
+	constexpr vec3(float a, float b, float c) : x(a), y(b), z(c) {}
+
+	//Component by axis, for code written over any dimension
+	constexpr float operator[](int axis) const { return axis == 0 ? x : (axis == 1 ? y : z); }
 
-	float square() const;
-	float mag() const;
-	float dot(const vec3& other) const;
-	vec3 unit() const;
+	constexpr float square() const { return (x * x) + (y * y) + (z * z); }
+	float mag() const { return std::sqrt(square()); }
+	constexpr float dot(const vec3& other) const { return (x * other.x) + (y * other.y) + (z * other.z); }
+	constexpr float distSquare(const vec3& other) const { return (*this - other).square(); }
+	//Zero and unit length vectors are returned unchanged
+	vec3 unit() const
+	{
+		float m = mag();
+		if (m != 1.0f && m != 0.0f)
+		{
+			float inv = 1.0f / m;
+			return vec3(x * inv, y * inv, z * inv);
+		}
+		return *this;
+	}
+	//this + dir * scale
+	constexpr vec3 mulAdd(const vec3& dir, float scale) const 
+	{
+		return vec3(x + dir.x * scale, y + dir.y * scale, z + dir.z * scale);
+	}
+	//Removes the component along a unit length direction
+	constexpr vec3 reject(const vec3& unitDir) const { return mulAdd(unitDir, -dot(unitDir)); }
+	constexpr vec3 cross(const vec3& other) const
+	{
+		return vec3(y * other.z - z * other.y, z * other.x - x * other.z, x * other.y - y * other.x);
+	}
+	//Per axis minimum and maximum, for bounding boxes
+	constexpr vec3 min(const vec3& other) const
+	{
+		return vec3(x < other.x ? x : other.x, y < other.y ? y : other.y, z < other.z ? z : other.z);
+	}
+	constexpr vec3 max(const vec3& other) const
+	{
+		return vec3(x > other.x ? x : other.x, y > other.y ? y : other.y, z > other.z ? z : other.z);
+	}
 
-	bool operator==(const vec3& rhs) const;
-	bool operator!=(const vec3& rhs) const;
-	vec3 operator+(const vec3& rhs) const;
-	vec3& operator+=(const vec3& rhs);
-	vec3 operator-(const vec3& rhs) const;
-	vec3& operator-=(const vec3& rhs);
-	vec3 operator*(const vec3& rhs) const;
-	vec3 operator*(const float& rhs) const;
-	vec3 operator/(const vec3& rhs) const;
-	vec3 operator/(const float& rhs) const;
+	constexpr bool operator==(const vec3& rhs) const { return x == rhs.x && y == rhs.y && z == rhs.z; }
+	constexpr bool operator!=(const vec3& rhs) const { return !(*this == rhs); }
+	constexpr vec3 operator-() const { return vec3(-x, -y, -z); }
+	constexpr vec3 operator+(const vec3& rhs) const { return vec3(x + rhs.x, y + rhs.y, z + rhs.z); }
+	constexpr vec3& operator+=(const vec3& rhs) { x += rhs.x; y += rhs.y; z += rhs.z; return *this; }
+	constexpr vec3 operator-(const vec3& rhs) const { return vec3(x - rhs.x, y - rhs.y, z - rhs.z); }
+	constexpr vec3& operator-=(const vec3& rhs) { x -= rhs.x; y -= rhs.y; z -= rhs.z; return *this; }
+	constexpr vec3 operator*(const vec3& rhs) const { return vec3(x * rhs.x, y * rhs.y, z * rhs.z); }
+	constexpr vec3 operator*(float rhs) const { return vec3(x * rhs, y * rhs, z * rhs); }
+	constexpr vec3 operator/(const vec3& rhs) const { return vec3(x / rhs.x, y / rhs.y, z / rhs.z); }
+	constexpr vec3 operator/(float rhs) const { return vec3(x / rhs, y / rhs, z / rhs); }
 };
 
+static_assert(std::is_trivially_copyable<vec3>::value, "vec3 must stay trivially copyable");
@@ -0,0 +1,282 @@
+#include "Simulation.h"
+#include "Profiler.h"
+#include "PerfCounters.h"
+
+#include <iostream>
+#include <iomanip>
+#include <string>
+#include <cstdlib>
+#include <chrono>
+#include <algorithm>
+
+//Runs the simulation without a window as fast as possible and reports the
+//throughput. Usage: Headless [--boids N] [--obstacles N] [--frames N]
+//[--warmup N] [--dt T] [--rvo] [--no-flocking] [--seed S] 
+//[--pattern uniform|clusters|ring|clump] [--extent E] [--trace PATH] 
+//[--trace-frames N] [--threads N] [--perf] [--3d] [--reorder K] [--compact]
+//[--sorted] [--index grid|kdtree|bvh] [--cell-width W] [--auto-cell]
+
+//Simulation phases timed separately when hardware counters are requested
+enum class RunPhase
+{
+	steering,
+	locomotion,
+	count
+};
+
+static void printPhase(const char* name, double seconds, const PerfCounters::Sample& sample,
+	int frames, int boids)
+{
+	double perBoid = 1.0 / ((double)frames * std::max(1, boids));
+	std::cout << std::left << std::setw(12) << name << std::right << std::fixed << std::setprecision(3)
+		<< std::setw(10) << seconds * 1000.0 / frames << " ms/frame";
+
+	const double* values = sample.values;
+	if (sample.valid[(int)PerfCounter::cycles] && sample.valid[(int)PerfCounter::instructions] &&
+		values[(int)PerfCounter::cycles] > 0.0)
+		std::cout << std::setprecision(2) << "  IPC " << values[(int)PerfCounter::instructions] / values[(int)PerfCounter::cycles];
+	else
+		std::cout << "  IPC n/a";
+	for (PerfCounter counter : { PerfCounter::cacheMisses, PerfCounter::branchMisses, PerfCounter::llcLoads })
+	{
+		std::cout << "  " << PerfCounters::getCounterName(counter) << "/boid ";
+		if (sample.valid[(int)counter])
+			std::cout << std::setprecision(2) << values[(int)counter] * perBoid;
+		else
+			std::cout << "n/a";
+	}
+	std::cout << std::defaultfloat << std::setprecision(6) << std::endl;
+}
+
+struct RunOptions
+{
+	int frames = 1000;
+	int warmup = 10;
+	float deltaT = 1.0f;
+	Scenario scenario;
+	ActorSettings settings;
+	std::string tracePath;
+	int traceFrames = 10;
+	int threads = 1;
+	bool usePerf = false;
+	bool volumetric = false;
+	//Frames between Morton reorders, negative keeps the simulation's default
+	int reorderInterval = -1;
+	//Quantised boid state, 2D only
+	bool compact = false;
+	//Counting sort the partition every frame instead of refiling boids as they move
+	bool sortedPartition = false;
+	SpatialIndexType index = SpatialIndexType::grid;
+	float cellWidth = 10.0f;
+	//Let the simulation retune the cell width as it runs
+	bool autoCellWidth = false;
+};
+
+//Instantiated for each dimension so the stepping loop is the same code the 
+//app would run, with the dimension fixed at compile time
+template<int D>
+static void runSimulation(const RunOptions& options)
+{
+	int frames = options.frames;
+	float deltaT = options.deltaT;
+	const Scenario& scenario = options.scenario;
+	const ActorSettings& settings = options.settings;
+	const std::string& tracePath = options.tracePath;
+	bool usePerf = options.usePerf;
+
+	//Counters have to be opened before the worker threads start so that 
+	//the threads inherit them
+	PerfCounters counters;
+	if (usePerf && !counters.open())
+		std::cout << "Hardware counters unavailable (" << counters.getError() 
+			<< "), reporting timings only" << std::endl;
+
+	//Same cell width in either dimension
+	BasicSimulation<D> simulation(options.cellWidth);
+	uint32_t seed = simulation.fillEntities(scenario);
+	simulation.applySettings(settings);
+	simulation.setThreadCount(options.threads);
+	if (options.reorderInterval >= 0)
+		simulation.setReorderInterval(options.reorderInterval);
+	if (options.compact)
+		simulation.setCompactState(true);
+	if (options.sortedPartition)
+		simulation.setPartitionMode(PartitionMode::sorted);
+	simulation.setSpatialIndex(options.index);
+	simulation.setAutoCellWidth(options.autoCellWidth);
+
+	for (int i = 0; i < options.warmup; i++)
+		simulation.step(deltaT);
+
+	Profiler::get().reset();
+	if (!tracePath.empty())
+		TraceRecorder::get().start(options.traceFrames);
+	double phaseSeconds[(int)RunPhase::count] = { 0.0, 0.0 };
+	PerfCounters::Sample phaseCounters[(int)RunPhase::count] = 
+		{ PerfCounters::emptySample(), PerfCounters::emptySample() };
+	auto start = std::chrono::steady_clock::now();
+	for (int i = 0; i < frames; i++)
+	{
+		if (usePerf)
+		{
+			//Split the frame to attribute counters to each phase
+			auto t0 = std::chrono::steady_clock::now();
+			PerfCounters::Sample s0 = counters.read();
+			simulation.steering();
+			auto t1 = std::chrono::steady_clock::now();
+			PerfCounters::Sample s1 = counters.read();
+			simulation.locomotion(deltaT);
+			auto t2 = std::chrono::steady_clock::now();
+			PerfCounters::Sample s2 = counters.read();
+
+			phaseSeconds[(int)RunPhase::steering] += std::chrono::duration<double>(t1 - t0).count();
+			phaseSeconds[(int)RunPhase::locomotion] += std::chrono::duration<double>(t2 - t1).count();
+			phaseCounters[(int)RunPhase::steering] += s1 - s0;
+			phaseCounters[(int)RunPhase::locomotion] += s2 - s1;
+		}
+		else
+			simulation.step(deltaT);
+		Profiler::get().endFrame();
+	}
+	auto end = std::chrono::steady_clock::now();
+
+	double seconds = std::chrono::duration<double>(end - start).count();
+	std::cout << scenario.numBoids << " boids, " << scenario.numObstacles << " obstacles, "
+		<< getPatternName(scenario.pattern) << " spawn in " << D << "D, "
+		<< (D == 2 && settings.useClearPath ? "RVO" : "simple") << " avoidance, "
+		<< (simulation.getCompactState() ? "compact" : "full float") << " state, "
+		<< (simulation.getPartitionMode() == PartitionMode::sorted ? "sorted" : "linked") << " partition, "
+		<< getSpatialIndexName(simulation.getSpatialIndex()) << " index, "
+		<< (options.autoCellWidth ? "tuned" : "fixed") << " cell width, seed " << seed << std::endl;
+	std::cout << frames << " frames in " << seconds << " s: "
+		<< frames / seconds << " steps/s, "
+		<< seconds * 1000.0 / frames << " ms/step" << std::endl;
+
+	if (usePerf)
+	{
+		printPhase("Steering", phaseSeconds[(int)RunPhase::steering],
+			phaseCounters[(int)RunPhase::steering], frames, scenario.numBoids);
+		printPhase("Locomotion", phaseSeconds[(int)RunPhase::locomotion],
+			phaseCounters[(int)RunPhase::locomotion], frames, scenario.numBoids);
+	}
+
+	if (!tracePath.empty())
+	{
+#if !BOIDS_PROFILING
+		std::cout << "Phase timers are compiled out, the trace only contains frames" << std::endl;
+#endif
+		if (TraceRecorder::get().write(tracePath))
+			std::cout << "Trace written to " << tracePath << std::endl;
+		else
+			std::cout << "Failed to write " << tracePath << std::endl;
+	}
+
+#if BOIDS_PROFILING
+	//Averages over the last Profiler::historySize frames
+	for (int i = 0; i < (int)ProfilePhase::boidDraw; i++)
+	{
+		Profiler::Stats stats = Profiler::get().getPhaseStats((ProfilePhase)i);
+		std::cout << Profiler::getPhaseName((ProfilePhase)i) << ": avg " << stats.average
+			<< " ms, p50 " << stats.p50 << " ms, p99 " << stats.p99 << " ms" << std::endl;
+	}
+	for (int i = 0; i < (int)ProfileCounter::count; i++)
+	{
+		Profiler::Stats stats = Profiler::get().getCounterStats((ProfileCounter)i);
+		std::cout << Profiler::getCounterName((ProfileCounter)i) << ": avg " << stats.average
+			<< " per frame, p99 " << stats.p99 << std::endl;
+	}
+	float collections = Profiler::get().getCounterStats(ProfileCounter::voCollections).average;
+	if (collections > 0.0f)
+		std::cout << "VOs per boid: " << (Profiler::get().getCounterStats(ProfileCounter::actorVOsBuilt).average +
+			Profiler::get().getCounterStats(ProfileCounter::obstacleVOsBuilt).average) / collections << std::endl;
+#endif
+
+	OccupancyStats occupancy = simulation.getPartition().computeOccupancy();
+	std::cout << "Partition: " << occupancy.occupiedCells << " occupied cells, mean " 
+		<< occupancy.meanOccupied << " actors, hottest cell (" << occupancy.maxCellX << ", " 
+		<< occupancy.maxCellY << (D == 3 ? ", " + std::to_string(occupancy.maxCellZ) : "") << ") with " 
+		<< occupancy.maxActors << ", " << occupancy.storedCells << " cells stored, cell width " 
+		<< simulation.getPartition().getPartitionWidth() << std::endl;
+	std::cout << "Cells by actor count:";
+	for (int i = 0; i < OccupancyStats::bucketCount; i++)
+		std::cout << " " << OccupancyStats::getBucketStart(i) 
+			<< (i == OccupancyStats::bucketCount - 1 ? "+:" : ":") << occupancy.histogram[i];
+	std::cout << std::endl;
+}
+
+int main(int argc, char* argv[])
+{
+	RunOptions options;
+
+	for (int i = 1; i < argc; i++)
+	{
+		std::string arg = argv[i];
+		bool hasValue = i + 1 < argc;
+		if (arg == "--boids" && hasValue)
+			options.scenario.numBoids = std::atoi(argv[++i]);
+		else if (arg == "--obstacles" && hasValue)
+			options.scenario.numObstacles = std::atoi(argv[++i]);
+		else if (arg == "--frames" && hasValue)
+			options.frames = std::atoi(argv[++i]);
+		else if (arg == "--warmup" && hasValue)
+			options.warmup = std::atoi(argv[++i]);
+		else if (arg == "--dt" && hasValue)
+			options.deltaT = (float)std::atof(argv[++i]);
+		else if (arg == "--rvo")
+			options.settings.useClearPath = true;
+		else if (arg == "--no-flocking")
+			options.settings.useFlocking = false;
+		else if (arg == "--seed" && hasValue)
+			options.scenario.seed = (uint32_t)std::strtoul(argv[++i], NULL, 10);
+		else if (arg == "--extent" && hasValue)
+			options.scenario.extent = (float)std::atof(argv[++i]);
+		else if (arg == "--threads" && hasValue)
+			options.threads = std::atoi(argv[++i]);
+		else if (arg == "--perf")
+			options.usePerf = true;
+		else if (arg == "--3d")
+			options.volumetric = true;
+		else if (arg == "--reorder" && hasValue)
+			options.reorderInterval = std::atoi(argv[++i]);
+		else if (arg == "--compact")
+			options.compact = true;
+		else if (arg == "--sorted")
+			options.sortedPartition = true;
+		else if (arg == "--trace" && hasValue)
+			options.tracePath = argv[++i];
+		else if (arg == "--trace-frames" && hasValue)
+			options.traceFrames = std::atoi(argv[++i]);
+		else if (arg == "--pattern" && hasValue && parsePatternName(argv[i + 1], options.scenario.pattern))
+			i++;
+		else if (arg == "--index" && hasValue && parseSpatialIndexName(argv[i + 1], options.index))
+			i++;
+		else if (arg == "--cell-width" && hasValue)
+		{
+			options.cellWidth = (float)std::atof(argv[++i]);
+			if (!(options.cellWidth > 0.0f))
+			{
+				std::cout << "--cell-width must be greater than 0" << std::endl;
+				return 1;
+			}
+		}
+		else if (arg == "--auto-cell")
+			options.autoCellWidth = true;
+		else
+		{
+			std::cout << "Unknown argument: " << arg << std::endl;
+			std::cout << "Usage: Headless [--boids N] [--obstacles N] [--frames N] "
+				"[--warmup N] [--dt T] [--rvo] [--no-flocking] [--seed S] "
+				"[--pattern uniform|clusters|ring|clump] [--extent E] "
+				"[--trace PATH] [--trace-frames N] [--threads N] [--perf] [--3d] [--reorder K] [--compact] "
+				"[--sorted] [--index grid|kdtree|bvh] [--cell-width W] [--auto-cell]" << std::endl;
+			return 1;
+		}
+	}
+
+	if (options.volumetric)
+		runSimulation<3>(options);
+	else
+		runSimulation<2>(options);
+
+	return 0;
+}